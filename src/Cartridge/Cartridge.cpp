@@ -1,4 +1,21 @@
-#include "cartridge.h"
+#include "Cartridge.h"
+
+std::mutex Cartridge::cacheMutex;
+std::unordered_map<std::string, std::weak_ptr<const Cartridge>> Cartridge::cache;
+
+std::shared_ptr<const Cartridge> Cartridge::load(const std::string& path) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(path);
+    if (it != cache.end()) {
+        if (auto image = it->second.lock()) {
+            return image;
+        }
+    }
+
+    auto image = std::make_shared<const Cartridge>(path);
+    cache[path] = image;
+    return image;
+}
 
 Cartridge::Cartridge(std::string path) {
     std::ifstream rom(path, std::ios_base::binary | std::ios_base::in);
@@ -58,22 +75,22 @@ Cartridge::Cartridge(std::string path) {
     }
 }
 
-std::vector<uint8_t> Cartridge::getROM() {
+std::span<const uint8_t> Cartridge::getROM() const {
     return PRG;
 }
 
-std::vector<uint8_t> Cartridge::getVROM() {
+std::span<const uint8_t> Cartridge::getVROM() const {
     return CHR;
 }
 
-uint8_t Cartridge::getMapper() {
+uint8_t Cartridge::getMapper() const {
     return mapperNumber;
 }
 
-uint8_t Cartridge::getNameTableMirroring() {
+uint8_t Cartridge::getNameTableMirroring() const {
     return nameTableMirroring;
 }
 
-bool Cartridge::hasExtendedRAM() {
+bool Cartridge::hasExtendedRAM() const {
     return extendedRAM;
 }
\ No newline at end of file
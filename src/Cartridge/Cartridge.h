@@ -1,8 +1,12 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <span>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 /*
 * From https://github.com/amhndu/SimpleNES/blob/master/include/Cartridge.h
@@ -15,15 +19,24 @@ enum NameTableMirroring {
     OneScreenHigher,
 };
 
+/*
+* A parsed iNES image. It is never modified after loading, so every mapper and
+* emulator instance that loads the same path shares one copy through load().
+*/
 class Cartridge {
 public:
     Cartridge(std::string path);
-    std::vector<uint8_t> getROM();
-    std::vector<uint8_t> getVROM();
-    uint8_t getMapper();
-    uint8_t getNameTableMirroring();
-    bool hasExtendedRAM();
+    static std::shared_ptr<const Cartridge> load(const std::string& path);
+
+    std::span<const uint8_t> getROM() const;
+    std::span<const uint8_t> getVROM() const;
+    uint8_t getMapper() const;
+    uint8_t getNameTableMirroring() const;
+    bool hasExtendedRAM() const;
 private:
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, std::weak_ptr<const Cartridge>> cache;
+
     std::vector<uint8_t> PRG;
     std::vector<uint8_t> CHR;
     uint8_t nameTableMirroring;
@@ -1,11 +1,11 @@
-#include "mapper.h"
+#include "Mapper.h"
 #include "nrom/nrom.h"
 
 NameTableMirroring Mapper::getNameTableMirroring() {
-    return static_cast<NameTableMirroring>(cartridge.getNameTableMirroring());
+    return static_cast<NameTableMirroring>(cartridge->getNameTableMirroring());
 }
 
-std::shared_ptr<Mapper> Mapper::createMapper(MapperType mapper_t, Cartridge& cart) {
+std::shared_ptr<Mapper> Mapper::createMapper(MapperType mapper_t, std::shared_ptr<const Cartridge> cart) {
     std::shared_ptr<Mapper> ret(nullptr);
     switch (mapper_t) {
         case NROM:
@@ -1,5 +1,6 @@
 #pragma once
-#include "../cartridge/cartridge.h"
+#include "../Cartridge/Cartridge.h"
+#include "../state/state.h"
 #include <functional>
 #include <memory>
 
@@ -20,7 +21,7 @@ enum MapperType {
 
 class Mapper {
 public: 
-    Mapper(Cartridge cart, MapperType mtype) : cartridge(cart), type(mtype) {}
+    Mapper(std::shared_ptr<const Cartridge> cart, MapperType mtype) : cartridge(cart), type(mtype) {}
     virtual void writePRG (uint16_t addr, uint8_t value) = 0;
     virtual uint8_t readPRG (uint16_t addr) = 0;
 
@@ -30,14 +31,61 @@ public:
     virtual NameTableMirroring getNameTableMirroring();
 
     bool inline hasExtendedRAM() {
-        return cartridge.hasExtendedRAM();
+        return cartridge->hasExtendedRAM();
     }
 
     virtual void scanlineIRQ(){}
 
-    static std::shared_ptr<Mapper> createMapper(MapperType mapper, Cartridge& cart);
+    /*
+    * Direct pointer to the 256 byte PRG page containing addr, or nullptr when
+    * reads from that page have to go through readPRG.
+    */
+    virtual const uint8_t* getPRGPage(uint16_t) { return nullptr; }
+
+    /*
+    * Direct pointer to the 1KB CHR bank containing addr, or nullptr when reads from
+    * that bank have to go through readCHR. CHR-RAM writes still go through writeCHR.
+    */
+    virtual const uint8_t* getCHRPage(uint16_t) { return nullptr; }
+
+    /*
+    * Save state section: bank registers and CHR-RAM. Mappers with bank registers
+    * call bankSwitched() and chrBankSwitched() once they are loaded.
+    */
+    virtual void saveState(StateWriter&) const {}
+    virtual void loadState(StateReader&) {}
+
+    MapperType getType() const {
+        return type;
+    }
+
+    void setBankSwitchCallback(std::function<void(void)> cb) {
+        bankSwitchCallback = cb;
+    }
+
+    void setCHRBankSwitchCallback(std::function<void(void)> cb) {
+        chrBankSwitchCallback = cb;
+    }
+
+    static std::shared_ptr<Mapper> createMapper(MapperType mapper, std::shared_ptr<const Cartridge> cart);
 
 protected:
-    Cartridge cartridge;
+    /*
+    * Mappers call this after changing PRG banks so the bus can refresh its page table.
+    */
+    void bankSwitched() {
+        if (bankSwitchCallback) bankSwitchCallback();
+    }
+
+    /*
+    * Same for CHR banks, the picture bus refreshes its CHR page table.
+    */
+    void chrBankSwitched() {
+        if (chrBankSwitchCallback) chrBankSwitchCallback();
+    }
+
+    std::shared_ptr<const Cartridge> cartridge;
     MapperType type;
+    std::function<void(void)> bankSwitchCallback;
+    std::function<void(void)> chrBankSwitchCallback;
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "nrom.h"
+
+MapperNROM::MapperNROM(std::shared_ptr<const Cartridge> cart) : Mapper(cart, MapperType::NROM) {
+    /*
+    * The bank table points into the shared ROM image, which outlives the mapper.
+    */
+    std::span<const uint8_t> rom = cartridge->getROM();
+    if (rom.size() == 0x4000) {
+        oneBank = true;
+        prgBanks[0] = prgBanks[1] = rom.data(); // mirrored
+    } else {
+        oneBank = false;
+        prgBanks[0] = rom.data();
+        prgBanks[1] = rom.data() + 0x4000;
+    }
+
+    characterROM = cartridge->getVROM();
+    if (characterROM.size() == 0) {
+        usesCharacterRAM = true;
+        characterRAM.resize(0x2000);
+    } else {
+        usesCharacterRAM = false;
+    }
+}
+
+uint8_t MapperNROM::readPRG(uint16_t addr) {
+    return prgBanks[(addr >> 14) & 1][addr & 0x3fff];
+}
+
+const uint8_t* MapperNROM::getPRGPage(uint16_t addr) {
+    return prgBanks[(addr >> 14) & 1] + (addr & 0x3f00);
+}
+
+const uint8_t* MapperNROM::getCHRPage(uint16_t addr) {
+    if (usesCharacterRAM) {
+        return &characterRAM[addr & 0x1c00];
+    }
+    return &characterROM[addr & 0x1c00];
+}
+
+/*
+* NROM has no bank registers, only CHR-RAM is saved.
+*/
+void MapperNROM::saveState(StateWriter& state) const {
+    if (usesCharacterRAM) {
+        state.write(characterRAM.data(), characterRAM.size());
+    }
+}
+
+void MapperNROM::loadState(StateReader& state) {
+    if (usesCharacterRAM) {
+        state.read(characterRAM.data(), characterRAM.size());
+    }
+}
+
+void MapperNROM::writePRG(uint16_t addr, uint8_t value) {
+    std::cout << "[NEMU] Error: ROM memory write attempt at " << +addr << " to set " << +value << std::endl;
+}
+
+uint8_t MapperNROM::readCHR(uint16_t addr) {
+    if (usesCharacterRAM) {
+        return characterRAM[addr];
+    } else {
+        return characterROM[addr];
+    }
+}
+
+void MapperNROM::writeCHR(uint16_t addr, uint8_t value) {
+    if (usesCharacterRAM) {
+        characterRAM[addr] = value;
+    } else {
+        std::cout << "[NEMU] Error: Read-only CHR memory write attempt at " << std::hex << addr << std::endl;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include "../Mapper.h"
+
+class MapperNROM : public Mapper {
+public:
+    MapperNROM(std::shared_ptr<const Cartridge> cart);
+    void writePRG (uint16_t addr, uint8_t value);
+    virtual uint8_t readPRG(uint16_t addr) override;
+    virtual const uint8_t* getPRGPage(uint16_t addr) override;
+    virtual const uint8_t* getCHRPage(uint16_t addr) override;
+    virtual void saveState(StateWriter& state) const override;
+    virtual void loadState(StateReader& state) override;
+
+    uint8_t readCHR (uint16_t addr);
+    void writeCHR (uint16_t addr, uint8_t value);
+private:
+    bool oneBank;
+    bool usesCharacterRAM;
+
+    const uint8_t* prgBanks[2];
+    std::span<const uint8_t> characterROM;
+
+    std::vector<uint8_t> characterRAM;
+};
\ No newline at end of file
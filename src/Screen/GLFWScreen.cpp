@@ -0,0 +1,81 @@
+#define GLAD_GL_IMPLEMENTATION
+#include "GLFWScreen.h"
+GLFWScreen::GLFWScreen() : window(nullptr), texture(0), pixelBuffers{0, 0}, pixelBufferIndex(0) {}
+
+void GLFWScreen::create(unsigned int width, unsigned int height, float pixel_size, Color color) {
+    Screen::create(width, height, pixel_size, color);
+
+    if (!glfwInit()) {
+        std::cout << "Failed to initialize GLFW\n";
+        exit(-1);
+        return;
+    }
+
+    window = glfwCreateWindow(ScreenWidth * pixelSize, ScreenHeight * pixelSize, "Screen", nullptr, nullptr);
+    if (!window) {
+        std::cout << "Failed to create GLFW window\n";
+        glfwTerminate();
+        exit(-1);
+        return;
+    }
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGL(glfwGetProcAddress)) {
+        std::cout << "Failed to load OpenGL\n";
+        glfwTerminate();
+        exit(-1);
+        return;
+    }
+
+    glOrtho(0, ScreenWidth, ScreenHeight, 0, -1, 1); // Set up an orthographic projection
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ScreenWidth, ScreenHeight, 0, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, frontBuffer);
+
+    glGenBuffers(2, pixelBuffers);
+    for (GLuint pixelBuffer : pixelBuffers) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, ScreenWidth * ScreenHeight * sizeof(uint32_t), frontBuffer, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void GLFWScreen::draw() {
+    if (!window) return;
+
+    const GLsizeiptr frameSize = ScreenWidth * ScreenHeight * sizeof(uint32_t);
+
+    /*
+    * Texture the quad from the buffer filled last frame while this frame goes into the other one.
+    * GL_UNSIGNED_INT_8_8_8_8 reads the packed RGBA pixels the same way on every endianness.
+    */
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[pixelBufferIndex]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, ScreenWidth, ScreenHeight, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, nullptr);
+
+    pixelBufferIndex ^= 1;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[pixelBufferIndex]);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+    if (void* pixels = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY)) {
+        std::memcpy(pixels, frontBuffer, frameSize);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glEnable(GL_TEXTURE_2D);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.f, 0.f); glVertex2f(0.f, 0.f);
+    glTexCoord2f(1.f, 0.f); glVertex2f(ScreenWidth, 0.f);
+    glTexCoord2f(1.f, 1.f); glVertex2f(ScreenWidth, ScreenHeight);
+    glTexCoord2f(0.f, 1.f); glVertex2f(0.f, ScreenHeight);
+    glEnd();
+    glDisable(GL_TEXTURE_2D);
+
+    glfwSwapBuffers(window);
+    glfwPollEvents();
+}
\ No newline at end of file
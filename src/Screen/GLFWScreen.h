@@ -0,0 +1,26 @@
+#pragma once
+#include <cstring>
+#include <glad/gl.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include "Screen.h"
+
+/*
+* Windowed backend: presents the front buffer through GLFW and OpenGL.
+*/
+class GLFWScreen : public Screen {
+public:
+    GLFWScreen();
+    void create(unsigned int width, unsigned int height, float pixel_size, Color color) override;
+    void draw() override;
+private:
+    GLFWwindow* window;
+
+    /*
+    * The frame is streamed through two pixel buffer objects into one texture,
+    * so the upload of a frame overlaps the emulation of the next one.
+    */
+    GLuint texture;
+    GLuint pixelBuffers[2];
+    int pixelBufferIndex;
+};
\ No newline at end of file
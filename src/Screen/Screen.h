@@ -1,21 +1,44 @@
 #pragma once
 #include <vector>
 #include <iostream>
-#include <GLFW/glfw3.h>
 #include <cstdint>
+#include <utility>
 #include "../color/color.h"
 
+/*
+* Frame sink of the PPU. The base class is the headless backend: it keeps frames in
+* memory and draw() does nothing, so it has no windowing dependency.
+* Front ends derive from it to present frames, see GLFWScreen.
+*/
 class Screen {
 public:
     Screen();
-    void create(unsigned int width, unsigned int height, float pixel_size, Color color);
+    virtual ~Screen() = default;
+    virtual void create(unsigned int width, unsigned int height, float pixel_size, Color color);
     void setPixel(size_t x, size_t y, Color color);
-    void draw() const;
-private:
+    virtual void draw() {}
+
+    /*
+    * Double buffered RGBA frames: the PPU renders straight into the back buffer and
+    * swapBuffers() hands it to draw() without copying.
+    */
+    uint32_t* getBackBuffer() {
+        return backBuffer;
+    }
+
+    const uint32_t* getFrontBuffer() const {
+        return frontBuffer;
+    }
+
+    void swapBuffers() {
+        std::swap(frontBuffer, backBuffer);
+    }
+protected:
     int ScreenWidth;
     int ScreenHeight;
     float pixelSize;
 
-    std::vector<Color> buffer;
-    GLFWwindow* window;
+    std::vector<uint32_t> frames[2];
+    uint32_t* frontBuffer;
+    uint32_t* backBuffer;
 };
\ No newline at end of file
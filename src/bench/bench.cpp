@@ -0,0 +1,227 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "emulator/emulator.h"
+#include "roms.h"
+
+#ifndef NEMU_BENCH_ROM_DIR
+#define NEMU_BENCH_ROM_DIR "bench_roms"
+#endif
+
+#define BenchRuns 3
+#define CPUBenchCycles 2000000
+#define PPUBenchDots 3000000
+#define BusBenchOps 10000000
+#define FrameBenchFrames 120
+
+struct BenchResult {
+    std::string name;
+    double value;
+    std::string unit;
+    double seconds;
+};
+
+/*
+* The components of an emulator built from one ROM, without its I/O wiring,
+* so single parts can be driven directly.
+*/
+struct Machine {
+    Machine(const std::string& path) : pScreen(createScreen()), system(Cartridge::load(path), *pScreen) {
+        system.ppu.reset();
+        system.processor.reset();
+    }
+
+    static std::shared_ptr<Screen> createScreen() {
+        auto screen = std::make_shared<Screen>();
+        screen->create(NESVideoWidth, NESVideoHeight, 1.f, Color(0, 0, 0, 255));
+        return screen;
+    }
+
+    std::shared_ptr<Screen> pScreen;
+    System system;
+};
+
+/*
+* Best of BenchRuns, each run on a fresh setup.
+*/
+template<typename Setup, typename Run>
+double bestTime(Setup setup, Run run) {
+    double best = 0;
+    for (int i = 0; i < BenchRuns; ++i) {
+        auto state = setup();
+        auto start = std::chrono::steady_clock::now();
+        run(state);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+static void benchCPU(const std::string& dir, double scale, std::vector<BenchResult>& results) {
+    uint64_t cycles = CPUBenchCycles * scale;
+    for (const auto& bench : cpuBenchmarks()) {
+        std::string path = dir + "/" + cpuBenchmarkROM(bench);
+        double seconds = bestTime([&]() {
+            auto machine = std::make_shared<Machine>(path);
+            for (int i = 0; i < 100; ++i) {
+                machine->system.processor.step(); // past the setup code
+            }
+            return machine;
+        }, [&](std::shared_ptr<Machine>& machine) {
+            for (uint64_t i = 0; i < cycles; ++i) {
+                machine->system.processor.step();
+            }
+        });
+        double instructions = double(cycles) / cpuBenchmarkCycles(bench) * BenchLoopInstructions;
+        results.push_back({"cpu/" + bench.name, instructions / seconds, "instructions/s", seconds});
+    }
+}
+
+static void benchPPU(const std::string& dir, double scale, std::vector<BenchResult>& results) {
+    struct Config {
+        std::string name;
+        uint8_t mask;
+    };
+    const Config configs[] = {
+        {"off",        0x00},
+        {"background", 0x0a},
+        {"sprites",    0x14},
+        {"both",       0x1e},
+    };
+
+    uint64_t dots = PPUBenchDots * scale;
+    auto sprites = benchmarkSprites();
+    auto palette = benchmarkPalette();
+    for (const auto& config : configs) {
+        double seconds = bestTime([&]() {
+            auto machine = std::make_shared<Machine>(dir + "/" + BenchFrameROM);
+            auto& ppu = machine->system.ppu;
+            ppu.setDataAddress(0x3f);
+            ppu.setDataAddress(0x00);
+            for (auto color : palette) {
+                ppu.setData(color);
+            }
+            ppu.setDataAddress(0x20);
+            ppu.setDataAddress(0x00);
+            for (int i = 0; i < 0x400; ++i) {
+                ppu.setData(uint8_t(i));
+            }
+            ppu.doDMA(sprites.data());
+            ppu.setMask(config.mask);
+            return machine;
+        }, [&](std::shared_ptr<Machine>& machine) {
+            for (uint64_t i = 0; i < dots; ++i) {
+                machine->system.ppu.step();
+            }
+        });
+        results.push_back({"ppu/" + config.name, dots / seconds, "dots/s", seconds});
+    }
+}
+
+static void benchBus(const std::string& dir, double scale, std::vector<BenchResult>& results) {
+    struct Access {
+        std::string name;
+        uint16_t base;
+        uint16_t mask;
+        bool write;
+    };
+    const Access accesses[] = {
+        {"read_ram",  0x0000, 0x1fff, false},
+        {"write_ram", 0x0000, 0x1fff, true},
+        {"read_prg",  0x8000, 0x7fff, false},
+        {"read_ppu",  0x2002, 0x0000, false},
+        {"write_ppu", 0x2005, 0x0000, true},
+    };
+
+    uint64_t ops = BusBenchOps * scale;
+    std::string path = dir + "/" + cpuBenchmarkROM(cpuBenchmarks().front());
+    for (const auto& access : accesses) {
+        volatile uint8_t sink = 0;
+        double seconds = bestTime([&]() {
+            return std::make_shared<Machine>(path);
+        }, [&](std::shared_ptr<Machine>& machine) {
+            auto& mainBus = machine->system.mainBus;
+            uint8_t value = 0;
+            for (uint64_t i = 0; i < ops; ++i) {
+                uint16_t addr = access.base | (i & access.mask);
+                if (access.write) {
+                    mainBus.write(addr, uint8_t(i));
+                } else {
+                    value += mainBus.read(addr);
+                }
+            }
+            sink = value;
+        });
+        results.push_back({"bus/" + access.name, seconds * 1e9 / ops, "ns/op", seconds});
+    }
+}
+
+static void benchFrames(const std::string& dir, double scale, std::vector<BenchResult>& results) {
+    uint64_t frames = FrameBenchFrames * scale;
+    if (!frames) {
+        frames = 1;
+    }
+    double seconds = bestTime([&]() {
+        auto emu = std::make_shared<emulator>(dir + "/" + BenchFrameROM);
+        for (int i = 0; i < 2; ++i) {
+            emu->runFrame(); // past the setup code
+        }
+        return emu;
+    }, [&](std::shared_ptr<emulator>& emu) {
+        for (uint64_t i = 0; i < frames; ++i) {
+            emu->runFrame();
+        }
+    });
+    results.push_back({"system/frames", frames / seconds, "frames/s", seconds});
+}
+
+/*
+* Prints one JSON document on stdout, so runs can be compared between releases.
+*/
+int main(int argc, char* argv[]) {
+    std::string dir = NEMU_BENCH_ROM_DIR;
+    double scale = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--roms" && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (arg == "--scale" && i + 1 < argc) {
+            scale = std::stod(argv[++i]);
+        } else {
+            std::cout << "Usage: nemu_bench [--roms <dir>] [--scale <factor>]\n";
+            return 1;
+        }
+    }
+
+    if (!std::filesystem::exists(dir + "/" + BenchFrameROM)) {
+        std::cout << "[NEMU] Error: Benchmark ROMs not found in " << dir << ", build the nemu_bench_roms target.\n";
+        return 1;
+    }
+
+    /*
+    * The core logs to std::cout, keep it out of the measurements and the report.
+    */
+    std::ostream report(std::cout.rdbuf());
+    std::cout.rdbuf(nullptr);
+
+    std::vector<BenchResult> results;
+    benchCPU(dir, scale, results);
+    benchPPU(dir, scale, results);
+    benchBus(dir, scale, results);
+    benchFrames(dir, scale, results);
+
+    report << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        report << "    {\"name\": \"" << result.name << "\", \"value\": " << result.value
+               << ", \"unit\": \"" << result.unit << "\", \"seconds\": " << result.seconds << "}"
+               << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    report << "  ]\n}\n";
+    return 0;
+}
\ No newline at end of file
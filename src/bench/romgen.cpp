@@ -0,0 +1,27 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "roms.h"
+
+static bool writeROM(const std::string& path, const std::vector<uint8_t>& image) {
+    std::ofstream out(path, std::ios_base::binary);
+    if (!out.write(reinterpret_cast<const char*>(image.data()), image.size())) {
+        std::cout << "[NEMU] Error: Couldn't write " << path << ".\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: nemu_romgen <output dir>\n";
+        return 1;
+    }
+    std::string dir = argv[1];
+
+    bool ok = writeROM(dir + "/" + BenchFrameROM, buildFrameBenchmarkROM());
+    for (const auto& bench : cpuBenchmarks()) {
+        ok = writeROM(dir + "/" + cpuBenchmarkROM(bench), buildCPUBenchmarkROM(bench)) && ok;
+    }
+    return ok ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "roms.h"
+#include <algorithm>
+#include "cpu/cpu.h"
+
+#define PRGSize 0x4000
+#define CHRSize 0x2000
+#define PRGBase 0x8000
+
+/*
+* Minimal PRG-ROM writer, addresses are CPU addresses in the $8000 bank.
+*/
+class ROMWriter {
+public:
+    ROMWriter() : prg(PRGSize, 0xea), pc(PRGBase) {}
+
+    uint16_t here() const {
+        return pc;
+    }
+
+    void org(uint16_t addr) {
+        pc = addr;
+    }
+
+    void emit(std::initializer_list<uint8_t> bytes) {
+        for (auto b : bytes) {
+            prg[(pc++ - PRGBase) & (PRGSize - 1)] = b;
+        }
+    }
+
+    void emit(const std::vector<uint8_t>& bytes) {
+        for (auto b : bytes) {
+            prg[(pc++ - PRGBase) & (PRGSize - 1)] = b;
+        }
+    }
+
+    void emitAddr(uint16_t addr) {
+        emit({uint8_t(addr), uint8_t(addr >> 8)});
+    }
+
+    void vectors(uint16_t nmi, uint16_t reset, uint16_t irq) {
+        org(NMIVector);
+        emitAddr(nmi);
+        emitAddr(reset);
+        emitAddr(irq);
+    }
+
+    std::vector<uint8_t> image(const std::vector<uint8_t>& chr) const {
+        const uint8_t header[0x10] = {'N', 'E', 'S', 0x1a, 1, 1, 0x1};
+        std::vector<uint8_t> rom(sizeof(header) + prg.size() + chr.size());
+        auto out = std::copy(header, header + sizeof(header), rom.begin());
+        out = std::copy(prg.begin(), prg.end(), out);
+        std::copy(chr.begin(), chr.end(), out);
+        return rom;
+    }
+private:
+    std::vector<uint8_t> prg;
+    uint16_t pc;
+};
+
+/*
+* Every tile gets a distinct pattern so both bit planes are non-zero.
+*/
+static std::vector<uint8_t> benchmarkCHR() {
+    std::vector<uint8_t> chr(CHRSize);
+    for (std::size_t i = 0; i < chr.size(); ++i) {
+        chr[i] = uint8_t((i >> 4) * 0x9d + (i & 0xf) * 0x35);
+    }
+    return chr;
+}
+
+const std::vector<CPUBenchmark>& cpuBenchmarks() {
+    static const std::vector<CPUBenchmark> benchmarks = {
+        {"Implied",     {0xe8}},                // INX
+        {"Accumulator", {0x0a}},                // ASL A
+        {"Immediate",   {0xa9, 0x42}},          // LDA #$42
+        {"ZeroPage",    {0xa5, 0x10}},          // LDA $10
+        {"ZeroPageX",   {0xb5, 0x10}},          // LDA $10,X
+        {"ZeroPageY",   {0xb6, 0x10}},          // LDX $10,Y
+        {"Absolute",    {0xad, 0x00, 0x03}},    // LDA $0300
+        {"AbsoluteX",   {0xbd, 0x00, 0x03}},    // LDA $0300,X
+        {"AbsoluteY",   {0xb9, 0x00, 0x03}},    // LDA $0300,Y
+        {"IndirectX",   {0xa1, 0x10}},          // LDA ($10,X)
+        {"IndirectY",   {0xb1, 0x20}},          // LDA ($20),Y
+    };
+    return benchmarks;
+}
+
+std::string cpuBenchmarkROM(const CPUBenchmark& bench) {
+    return "cpu_" + bench.name + ".nes";
+}
+
+int cpuBenchmarkCycles(const CPUBenchmark& bench) {
+    return OperationCycles[bench.body[0]] * BenchBodyRepeat + OperationCycles[0x4c];
+}
+
+std::vector<uint8_t> buildCPUBenchmarkROM(const CPUBenchmark& bench) {
+    ROMWriter rom;
+    uint16_t reset = rom.here();
+    rom.emit({
+        0xa2, 0x01,                                     // LDX #$01
+        0xa0, 0x01,                                     // LDY #$01
+        0xa9, uint8_t(BenchOperandAddress),             // LDA #<operand
+        0x85, 0x11,                                     // STA $11, ($10,X) pointer
+        0x85, 0x20,                                     // STA $20, ($20),Y pointer
+        0xa9, uint8_t(BenchOperandAddress >> 8),        // LDA #>operand
+        0x85, 0x12,                                     // STA $12
+        0x85, 0x21,                                     // STA $21
+    });
+
+    uint16_t loop = rom.here();
+    for (int i = 0; i < BenchBodyRepeat; ++i) {
+        rom.emit(bench.body);
+    }
+    rom.emit({0x4c});                                   // JMP loop
+    rom.emitAddr(loop);
+
+    uint16_t rti = rom.here();
+    rom.emit({0x40});                                   // RTI
+
+    rom.vectors(rti, reset, rti);
+    return rom.image(benchmarkCHR());
+}
+
+std::vector<uint8_t> benchmarkSprites() {
+    std::vector<uint8_t> sprites(0x100);
+    for (int i = 0; i < 64; ++i) {
+        sprites[i * 4 + 0] = uint8_t(8 + (i % 8) * 28);     // Y, 8 sprites per band
+        sprites[i * 4 + 1] = uint8_t(i);                    // tile
+        sprites[i * 4 + 2] = uint8_t((i & 3) | (i & 0x20)); // palette and priority
+        sprites[i * 4 + 3] = uint8_t(i * 4);                // X
+    }
+    return sprites;
+}
+
+std::vector<uint8_t> benchmarkPalette() {
+    std::vector<uint8_t> palette(0x20);
+    for (std::size_t i = 0; i < palette.size(); ++i) {
+        palette[i] = uint8_t((i * 7) & 0x3f);
+    }
+    return palette;
+}
+
+std::vector<uint8_t> buildFrameBenchmarkROM() {
+    ROMWriter rom;
+
+    uint16_t sprites = 0x9000;
+    uint16_t palette = 0x9100;
+    rom.org(sprites);
+    rom.emit(benchmarkSprites());
+    rom.org(palette);
+    rom.emit(benchmarkPalette());
+
+    rom.org(PRGBase);
+    uint16_t reset = rom.here();
+    rom.emit({
+        0x78,                       // SEI
+        0xd8,                       // CLD
+        0xa2, 0xff,                 // LDX #$ff
+        0x9a,                       // TXS
+        0xe8,                       // INX
+    });
+    uint16_t copySprites = rom.here();
+    rom.emit({0xbd});               // LDA sprites,X
+    rom.emitAddr(sprites);
+    rom.emit({
+        0x9d, 0x00, 0x02,           // STA $0200,X
+        0xe8,                       // INX
+        0xd0, uint8_t(copySprites - (rom.here() + 2)), // BNE copySprites
+        0xa9, 0x02,                 // LDA #$02
+        0x8d, 0x14, 0x40,           // STA OAMDMA
+        0xa9, 0x3f,                 // LDA #$3f
+        0x8d, 0x06, 0x20,           // STA PPUADDR
+        0xa9, 0x00,                 // LDA #$00
+        0x8d, 0x06, 0x20,           // STA PPUADDR
+    });
+    uint16_t copyPalette = rom.here();
+    rom.emit({0xbd});               // LDA palette,X
+    rom.emitAddr(palette);
+    rom.emit({
+        0x8d, 0x07, 0x20,           // STA PPUDATA
+        0xe8,                       // INX
+        0xe0, 0x20,                 // CPX #$20
+        0xd0, uint8_t(copyPalette - (rom.here() + 2)), // BNE copyPalette
+        0xa9, 0x20,                 // LDA #$20
+        0x8d, 0x06, 0x20,           // STA PPUADDR
+        0xa9, 0x00,                 // LDA #$00
+        0x8d, 0x06, 0x20,           // STA PPUADDR
+        0xa0, 0x04,                 // LDY #$04
+        0xa2, 0x00,                 // LDX #$00
+    });
+    uint16_t fillNameTable = rom.here();
+    rom.emit({
+        0x8a,                       // TXA
+        0x8d, 0x07, 0x20,           // STA PPUDATA
+        0xe8,                       // INX
+        0xd0, uint8_t(fillNameTable - (rom.here() + 2)), // BNE fillNameTable
+        0x88,                       // DEY
+        0xd0, uint8_t(fillNameTable - (rom.here() + 2)), // BNE fillNameTable
+        0xa9, 0x80,                 // LDA #$80, NMI on
+        0x8d, 0x00, 0x20,           // STA PPUCTRL
+        0xa9, 0x1e,                 // LDA #$1e, background and sprites
+        0x8d, 0x01, 0x20,           // STA PPUMASK
+    });
+    uint16_t idle = rom.here();
+    rom.emit({
+        0xe6, 0x00,                 // INC $00
+        0x4c,                       // JMP idle
+    });
+    rom.emitAddr(idle);
+
+    uint16_t nmi = rom.here();
+    rom.emit({
+        0x48,                       // PHA
+        0xad, 0x02, 0x20,           // LDA PPUSTATUS
+        0xa9, 0x00,                 // LDA #$00
+        0x8d, 0x05, 0x20,           // STA PPUSCROL
+        0x8d, 0x05, 0x20,           // STA PPUSCROL
+        0xa9, 0x02,                 // LDA #$02
+        0x8d, 0x14, 0x40,           // STA OAMDMA
+        0x68,                       // PLA
+        0x40,                       // RTI
+    });
+
+    uint16_t irq = rom.here();
+    rom.emit({0x40});               // RTI
+
+    rom.vectors(nmi, reset, irq);
+    return rom.image(benchmarkCHR());
+}
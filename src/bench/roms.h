@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+* Synthetic NROM images for nemu_bench, written to the build directory by nemu_romgen.
+*/
+#define BenchBodyRepeat 16
+#define BenchLoopInstructions (BenchBodyRepeat + 1) // the repeated body and the JMP back
+#define BenchOperandAddress 0x0300
+#define BenchFrameROM "frame.nes"
+
+/*
+* One CPU benchmark: a loop running body BenchBodyRepeat times, then JMP back.
+* The operands never cross a page, so every iteration takes the same number of cycles.
+*/
+struct CPUBenchmark {
+    std::string name;
+    std::vector<uint8_t> body;
+};
+
+const std::vector<CPUBenchmark>& cpuBenchmarks();
+
+std::string cpuBenchmarkROM(const CPUBenchmark& bench);
+
+/*
+* CPU cycles of one loop iteration, which always runs BenchLoopInstructions instructions.
+*/
+int cpuBenchmarkCycles(const CPUBenchmark& bench);
+
+std::vector<uint8_t> buildCPUBenchmarkROM(const CPUBenchmark& bench);
+
+/*
+* Renders a full background and 64 sprites, with an NMI handler doing OAM DMA every frame.
+*/
+std::vector<uint8_t> buildFrameBenchmarkROM();
+
+/*
+* Sprite table and palette used by the frame ROM, reused by the PPU benchmark.
+*/
+std::vector<uint8_t> benchmarkSprites();
+std::vector<uint8_t> benchmarkPalette();
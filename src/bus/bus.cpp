@@ -1,34 +1,107 @@
 #include "bus.h"
 
-bus::bus(std::shared_ptr<Mapper> map, std::shared_ptr<PPU> ppunit) : ram(0x800, 0), mapper(map), ppu(ppunit) {
-    if (!mapper) {
-        std::cout << "[NEMU] Error: Mapper pointer is null.\n";
+const std::array<bus::PPURegisterRead, 8> bus::ppuReads = {
+    nullptr,            // PPUCTRL
+    nullptr,            // PPUMASK
+    &PPU::getStatus,    // PPUSTATUS
+    nullptr,            // OAMADDR
+    &PPU::getOAMData,   // OAMDATA
+    nullptr,            // PPUSCROL
+    nullptr,            // PPUADDR
+    &PPU::getData,      // PPUDATA
+};
+
+const std::array<bus::PPURegisterWrite, 8> bus::ppuWrites = {
+    &PPU::control,          // PPUCTRL
+    &PPU::setMask,          // PPUMASK
+    nullptr,                // PPUSTATUS
+    &PPU::setOAMAddress,    // OAMADDR
+    &PPU::setOAMData,       // OAMDATA
+    &PPU::setScroll,        // PPUSCROL
+    &PPU::setDataAddress,   // PPUADDR
+    &PPU::setData,          // PPUDATA
+};
+
+bus::bus(Mapper& map, PPU& ppunit) : ppu(&ppunit), mapper(&map), ram{} {
+    if (mapper->hasExtendedRAM()) {
+        extendedRAM.resize(0x2000);
     }
 
-    if (!ppunit) {
-        std::cout << "[NEMU] Error: PPU pointer is null.\n";
+    mapPages();
+    mapper->setBankSwitchCallback([this]() { mapPRG(); });
+}
+
+void bus::mapPages() {
+    readPages.fill(nullptr);
+    writePages.fill(nullptr);
+
+    for (int page = 0x00; page < 0x20; ++page) { // RAM and its mirrors
+        readPages[page] = writePages[page] = &ram[(page << 8) & 0x7ff];
     }
 
     if (mapper->hasExtendedRAM()) {
-        extendedRAM.resize(0x2000);
+        /*
+        * $6000 stays on the handler so test ROM results are still reported.
+        */
+        for (int page = 0x60; page < 0x80; ++page) {
+            readPages[page] = &extendedRAM[(page << 8) - 0x6000];
+            if (page != 0x60) {
+                writePages[page] = &extendedRAM[(page << 8) - 0x6000];
+            }
+        }
+    }
+
+    mapPRG();
+}
+
+void bus::mapPRG() {
+    for (int page = 0x80; page < 0x100; ++page) {
+        const uint8_t* prgPage = mapper->getPRGPage(page << 8);
+        if (prgPage != readPages[page]) {
+            readPages[page] = prgPage;
+            if (prgRemapCallback) {
+                prgRemapCallback(page);
+            }
+        }
     }
 }
 
 uint8_t bus::read(uint16_t addr) {
+    const uint8_t* page = readPages[addr >> 8];
+    if (page) {
+        return page[addr & 0xff];
+    }
+    return readHandler(addr);
+}
+
+void bus::write(uint16_t addr, uint8_t val) {
+    uint8_t* page = writePages[addr >> 8];
+    if (page) {
+        page[addr & 0xff] = val;
+        return;
+    }
+    writeHandler(addr, val);
+}
+
+uint8_t bus::readHandler(uint16_t addr) {
     if (addr < 0x2000) { // RAM
         return ram[addr & 0x7ff];
     } else if (addr < 0x4020) { // PPU and IO 
         if (addr < 0x4000) { // PPU and Mirrored PPU
-            auto it = readCallbacks.find(static_cast<IORegisters>(addr & 0x2007));
-                if (it != readCallbacks.end()) {
-                    return (it -> second)();
-                } else {
-                    std::cout << "[NEMU] Error: No read callback registered for I/O register at: " << std::hex << +addr << std::endl;
-                }
+            ppu->catchUp();
+            if (PPURegisterRead handler = ppuReads[addr & 0x7]) {
+                return (ppu->*handler)();
+            }
+            auto& callback = readCallbacks[ioRegisterSlot(addr)];
+            if (callback) {
+                return callback();
+            } else {
+                std::cout << "[NEMU] Error: No read callback registered for I/O register at: " << std::hex << +addr << std::endl;
+            }
         } else if (addr < 0x4018 && addr >= 0x4014) { // IO
-            auto it = readCallbacks.find(static_cast<IORegisters>(addr));
-            if (it != readCallbacks.end()) {
-                return (it -> second)();
+            auto& callback = readCallbacks[ioRegisterSlot(addr)];
+            if (callback) {
+                return callback();
             } else {
                 std::cout << "[NEMU] Error: No read callback registered for I/O register at: " << std::hex << +addr << std::endl;
             }
@@ -48,7 +121,7 @@ uint8_t bus::read(uint16_t addr) {
     return 0;
 }
 
-void bus::write(uint16_t addr, uint8_t val) {
+void bus::writeHandler(uint16_t addr, uint8_t val) {
     if (addr == 0x6000) {
         std::cout << "[NEMU] INFO: Test Results = " << std::hex << val << std::endl;
     }
@@ -56,19 +129,24 @@ void bus::write(uint16_t addr, uint8_t val) {
         std::cout << "[NEMU] INFO: Test Results = " << std::hex << val << std::endl;
     }
     if (addr < 0x2000) { // RAM
-        ram[addr & Ram.end] = val;
+        ram[addr & 0x7ff] = val;
     } else if (addr < 0x4020) { // PPU and IO 
         if (addr < 0x4000) { // PPU and Mirrored PPU
-            auto it = writeCallbacks.find(static_cast<IORegisters>(addr & 0x2007));
-                if (it != writeCallbacks.end()) {
-                    (it -> second)(val);
-                } else {
-                    std::cout << "[NEMU] Error: No write callback registered for I/O register at: " << std::hex << +addr << std::endl;
-                }
+            ppu->catchUp();
+            if (PPURegisterWrite handler = ppuWrites[addr & 0x7]) {
+                (ppu->*handler)(val);
+                return;
+            }
+            auto& callback = writeCallbacks[ioRegisterSlot(addr)];
+            if (callback) {
+                callback(val);
+            } else {
+                std::cout << "[NEMU] Error: No write callback registered for I/O register at: " << std::hex << +addr << std::endl;
+            }
         } else if (addr < 0x4017 && addr >= 0x4014) { // IO
-            auto it = writeCallbacks.find(static_cast<IORegisters>(addr));
-            if (it != writeCallbacks.end()) {
-                (it -> second)(val);
+            auto& callback = writeCallbacks[ioRegisterSlot(addr)];
+            if (callback) {
+                callback(val);
             } else {
                 std::cout << "[NEMU] Error: No write callback registered for I/O register at: " << std::hex << +addr << std::endl;
             }
@@ -82,16 +160,47 @@ void bus::write(uint16_t addr, uint8_t val) {
             extendedRAM[addr - 0x6000] = val;
         }
     } else { // PRG
+        ppu->catchUp(); // bank switches change what the PPU fetches
         mapper->writePRG(addr, val);
     }
 }
 
+uint8_t bus::peek(uint16_t addr) {
+    const uint8_t* page = readPages[addr >> 8];
+    if (page) {
+        return page[addr & 0xff];
+    } else if (addr >= 0x8000) {
+        return mapper->readPRG(addr);
+    } else if (addr >= 0x6000 && mapper->hasExtendedRAM()) {
+        return extendedRAM[addr - 0x6000];
+    }
+    return 0;
+}
+
+void bus::saveState(StateWriter& state) const {
+    state.write(ram);
+    if (mapper->hasExtendedRAM()) {
+        state.write(extendedRAM.data(), extendedRAM.size());
+    }
+}
+
+void bus::loadState(StateReader& state) {
+    state.read(ram);
+    if (mapper->hasExtendedRAM()) {
+        state.read(extendedRAM.data(), extendedRAM.size());
+    }
+}
+
 bool bus::setWriteCallback(IORegisters reg, std::function<void(uint8_t)> callback) {
     if (!callback) {
         std::cout << "[NEMU] Error: Callback argument is null\n";
         return false;
     }
-    return writeCallbacks.emplace(reg, callback).second;
+    if ((reg < 0x4000 && ppuWrites[reg & 0x7]) || writeCallbacks[ioRegisterSlot(reg)]) {
+        return false;
+    }
+    writeCallbacks[ioRegisterSlot(reg)] = callback;
+    return true;
 }
 
 bool bus::setReadCallback(IORegisters reg, std::function<uint8_t(void)> callback) {
@@ -99,7 +208,11 @@ bool bus::setReadCallback(IORegisters reg, std::function<uint8_t(void)> callback
         std::cout << "[NEMU] Error: Callback argument is null\n";
         return false;
     }
-    return readCallbacks.emplace(reg, callback).second;
+    if ((reg < 0x4000 && ppuReads[reg & 0x7]) || readCallbacks[ioRegisterSlot(reg)]) {
+        return false;
+    }
+    readCallbacks[ioRegisterSlot(reg)] = callback;
+    return true;
 }
 
 const uint8_t* bus::getPagePtr(uint8_t page) {
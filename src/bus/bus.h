@@ -1,8 +1,8 @@
 #pragma once
 #include <vector>
 #include <iostream>
-#include <unordered_map>
 #include <functional>
+#include <array>
 #include "../range/range.h"
 #include "../Mapper/Mapper.h"
 #include "../ppu/ppu.h"
@@ -21,7 +21,7 @@
 #define cartridge range(0x4020, 0xFFFF, 0xBFE0) // Cartridge space: PRG ROM, PRG RAM, and mapper registers
 
 /*
-* IO Registers and IO Registers Hasher found in https://github.com/amhndu/SimpleNES/blob/master/include/MainBus.h
+* IO Registers found in https://github.com/amhndu/SimpleNES/blob/master/include/MainBus.h
 */
 
 enum IORegisters {
@@ -38,15 +38,18 @@ enum IORegisters {
     JOY2 = 0x4017,
 };
 
-struct IORegistersHasher {
-    std::size_t operator()(IORegisters const & reg) const noexcept {
-        return std::hash<std::uint32_t>{}(reg);
-    }
-};
+/*
+* Callback slots: $2000-$2007 map to 0-7, $4014-$4017 map to 8-11.
+*/
+#define IORegisterSlots 12
+
+inline std::size_t ioRegisterSlot(uint16_t addr) {
+    return addr < 0x4000 ? (addr & 0x7) : 8 + (addr - OAMDMA);
+}
 
 class bus {
 public:
-    bus(std::shared_ptr<Mapper> map, std::shared_ptr<PPU> ppunit);
+    bus(Mapper& map, PPU& ppunit);
 
     uint8_t read(uint16_t addr);
     void write(uint16_t addr, uint8_t val);
@@ -54,12 +57,79 @@ public:
     bool setReadCallback(IORegisters reg, std::function<uint8_t(void)> callback);
     const uint8_t* getPagePtr(uint8_t page);
 
+    /*
+    * Debugger access: peek reads without side effects (I/O registers read as 0).
+    */
+    uint8_t peek(uint16_t addr);
+    uint32_t getPPUFrameDot() const {
+        return ppu->getFrameDot();
+    }
+    int getPPUEventFreeDots() const {
+        return ppu->eventFreeDotsLeft();
+    }
+    bool getPPUVBlankFlag() const {
+        return ppu->getVBlankFlag();
+    }
+
+    /*
+    * Lets the PPU fall behind by dots, for CPU cores that run ahead of the emulator loop.
+    * Must stay within getPPUEventFreeDots().
+    */
+    void deferPPU(int dots) {
+        ppu->defer(dots);
+    }
+
+    /*
+    * Direct read pointer of a page, nullptr when reads of the page go through the handlers.
+    */
+    const uint8_t* getReadPage(uint8_t page) const {
+        return readPages[page];
+    }
+
+    /*
+    * Called with every $8000-$FFFF page whose PRG bank changed, so decoded code can be dropped.
+    */
+    void setPRGRemapCallback(std::function<void(uint8_t)> callback) {
+        prgRemapCallback = callback;
+    }
+
+    /*
+    * Save state section: RAM and extended RAM. The page tables point into them and stay valid.
+    */
+    void saveState(StateWriter& state) const;
+    void loadState(StateReader& state);
+
 private:
-    std::shared_ptr<PPU> ppu;
-    std::shared_ptr<Mapper> mapper;
-    std::vector<uint8_t> ram;
+    uint8_t readHandler(uint16_t addr);
+    void writeHandler(uint16_t addr, uint8_t val);
+    void mapPages();
+    void mapPRG();
+
+    using PPURegisterRead = uint8_t (PPU::*)();
+    using PPURegisterWrite = void (PPU::*)(uint8_t);
+
+    /*
+    * PPU register handlers indexed by addr & 7, nullptr for registers without a read or write side.
+    */
+    static const std::array<PPURegisterRead, 8> ppuReads;
+    static const std::array<PPURegisterWrite, 8> ppuWrites;
+
+    /*
+    * One entry per 256 byte page. A nullptr page falls back to readHandler / writeHandler.
+    */
+    std::array<const uint8_t*, 0x100> readPages;
+    std::array<uint8_t*, 0x100> writePages;
+
+    PPU* ppu;
+    Mapper* mapper;
+    std::array<uint8_t, 0x800> ram;
+
+    /*
+    * $6000-$7FFF, only allocated for mappers with extended RAM.
+    */
     std::vector<uint8_t> extendedRAM;
 
-    std::unordered_map<IORegisters, std::function<void(uint8_t)>, IORegistersHasher> writeCallbacks;
-    std::unordered_map<IORegisters, std::function<uint8_t(void)>, IORegistersHasher> readCallbacks;
+    std::array<std::function<void(uint8_t)>, IORegisterSlots> writeCallbacks;
+    std::array<std::function<uint8_t(void)>, IORegisterSlots> readCallbacks;
+    std::function<void(uint8_t)> prgRemapCallback;
 };
\ No newline at end of file
@@ -10,8 +10,12 @@ struct Color {
         a = rgba & 0xFF;         // Extract alpha component
     }
 
-    int r;
-    int g;
-    int b;
-    int a;
+    uint32_t rgba() const {
+        return r << 24 | g << 16 | b << 8 | a;
+    }
+
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
 };
\ No newline at end of file
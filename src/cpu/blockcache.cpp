@@ -0,0 +1,84 @@
+#include "cpu.h"
+#include <algorithm>
+
+const std::array<bool, 0x100> cpu::implemented = [] {
+    std::array<bool, 0x100> table{};
+#define CPU_IMPLEMENTED_ENTRY(opcode, ...) table[opcode] = true;
+    CPU_OPERATIONS(CPU_IMPLEMENTED_ENTRY)
+#undef CPU_IMPLEMENTED_ENTRY
+    return table;
+}();
+
+/*
+* Instructions that leave straight-line code: BRK, JSR, RTI, JMP, RTS, JMP () and the branches.
+*/
+bool cpu::endsBlock(uint8_t opcode) {
+    switch (opcode) {
+        case 0x00:
+        case 0x20:
+        case 0x40:
+        case 0x4C:
+        case 0x60:
+        case 0x6C:
+            return true;
+        default:
+            return opcodeInfo(opcode).format == OperandRelative;
+    }
+}
+
+bool cpu::decodeBlock(uint16_t addr) {
+    const uint8_t* page = Bus->getReadPage(addr >> 8);
+    if (!page) {
+        return false;
+    }
+
+    /*
+    * Blocks never cross a page, so remapping a page only drops the blocks decoded from it.
+    */
+    DecodedInstruction* block = &decodedCode[(addr & 0xff00) - PRGCodeStart];
+    for (int offset = addr & 0xff; offset < 0x100;) {
+        uint8_t opcode = page[offset];
+        int length = instructionLength(opcode);
+        if (!implemented[opcode] || offset + length > 0x100 || block[offset].length) {
+            break;
+        }
+
+        DecodedInstruction& instruction = block[offset];
+        instruction.opcode = opcode;
+        instruction.length = length;
+        instruction.cycles = OperationCycles[opcode];
+        instruction.operand = 0;
+        for (int i = 1; i < length; ++i) {
+            instruction.operand |= page[offset + i] << (8 * (i - 1));
+        }
+
+        offset += length;
+        if (endsBlock(opcode)) {
+            break;
+        }
+    }
+    return block[addr & 0xff].length;
+}
+
+DecodedInstruction cpu::decodeInstruction(uint16_t addr) {
+    DecodedInstruction instruction;
+    instruction.opcode = Bus->read(addr);
+    instruction.length = instructionLength(instruction.opcode);
+    instruction.cycles = OperationCycles[instruction.opcode];
+    instruction.operand = 0;
+    for (int i = 1; i < instruction.length; ++i) {
+        instruction.operand |= Bus->read(addr + i) << (8 * (i - 1));
+    }
+    return instruction;
+}
+
+void cpu::invalidateCode(uint8_t page) {
+    if (page >= (PRGCodeStart >> 8)) {
+        auto first = decodedCode.begin() + ((page << 8) - PRGCodeStart);
+        std::fill(first, first + 0x100, DecodedInstruction{});
+#if NEMU_JIT
+        auto compiled = compiledCode.begin() + ((page << 8) - PRGCodeStart);
+        std::fill(compiled, compiled + 0x100, CompiledBlock{});
+#endif
+    }
+}
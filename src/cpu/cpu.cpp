@@ -1,8 +1,12 @@
 #include "cpu.h"
 
-cpu::cpu(std::shared_ptr<bus> pBus) : Bus(pBus) {
+cpu::cpu(bus& mainBus) : Bus(&mainBus), decodedCode(0x10000 - PRGCodeStart) {
+#if NEMU_JIT
+    compiledCode.resize(0x10000 - PRGCodeStart);
+#endif
     status.pendingIRQ = false;
     status.pendingNMI = false;
+    Bus->setPRGRemapCallback([this](uint8_t page) { invalidateCode(page); });
 }
 
 void cpu::reset(uint16_t start_addr) {
@@ -11,16 +15,39 @@ void cpu::reset(uint16_t start_addr) {
     accumulator = 0;
     x_reg = 0;
     y_reg = 0;
-    status.I = true;
-    status.C = false;
-    status.D = false;
-    status.N = false;
-    status.V = false;
-    status.Z = false;
+    status.unpack(UnusedFlag | InterruptFlag);
     program_counter = start_addr;
     stack_pointer = 0xfd;
 }
 
+void cpu::saveState(StateWriter& state) const {
+    state.write(accumulator);
+    state.write(x_reg);
+    state.write(y_reg);
+    state.write(status.flags);
+    state.write(status.result);
+    state.write(status.pendingNMI);
+    state.write(status.pendingIRQ);
+    state.write(stack_pointer);
+    state.write(program_counter);
+    state.write(skipCycles);
+    state.write(cycles);
+}
+
+void cpu::loadState(StateReader& state) {
+    state.read(accumulator);
+    state.read(x_reg);
+    state.read(y_reg);
+    state.read(status.flags);
+    state.read(status.result);
+    state.read(status.pendingNMI);
+    state.read(status.pendingIRQ);
+    state.read(stack_pointer);
+    state.read(program_counter);
+    state.read(skipCycles);
+    state.read(cycles);
+}
+
 uint16_t cpu::readAddr(uint16_t addr) {
     return Bus->read(addr) | Bus->read(addr + 1) << 8;
 }
@@ -36,7 +63,7 @@ uint8_t cpu::pullStack() {
 }
 
 void cpu::InterruptSeq(Interrupt type) {
-    if (status.I && type != NMI && type != Interrupt::BRK){
+    if (status.get(InterruptFlag) && type != NMI && type != Interrupt::BRK){
         return;
     }
 
@@ -47,10 +74,9 @@ void cpu::InterruptSeq(Interrupt type) {
     pushStack(program_counter >> 8);
     pushStack(program_counter);
 
-    uint8_t flags = status.N << 7 | status.V << 6 | 1 << 5 | (type == Interrupt::BRK) << 4 | status.D << 3 | status.I << 2 | status.Z << 1 | status.C;
-    pushStack(flags);
+    pushStack(status.pack() | (type == Interrupt::BRK) << 4);
 
-    status.I = true;
+    status.set(InterruptFlag, true);
 
     switch (type) {
         case Interrupt::IRQ:
@@ -66,19 +92,18 @@ void cpu::InterruptSeq(Interrupt type) {
 }
 
 void cpu::setZN(uint8_t value) {
-    status.Z = !value;
-    status.N = value & 0x80;
+    status.result = value;
 }
 
 void cpu::reset() {
     reset(readAddr(ResetVector));
 }
 
-void cpu::step() {
+int cpu::step(int budget) {
     ++cycles;
 
     if (skipCycles-- > 1){
-        return;
+        return 1;
     }
 
     skipCycles = 0;
@@ -87,25 +112,88 @@ void cpu::step() {
         InterruptSeq(NMI);
         status.pendingNMI = false;
         status.pendingIRQ = false;
-        return;
+        return 1;
     } else if (status.pendingIRQ) {
         InterruptSeq(IRQ);
         status.pendingNMI = false;
         status.pendingIRQ = false;
-        return;
+        return 1;
     }
 
-    uint8_t opcode = Bus->read(program_counter++);
-    auto CycleLength = OperationCycles[opcode];
+    /*
+    * PRG-ROM code comes pre-decoded from decodedCode, code in RAM or behind mapper
+    * handlers is decoded through the bus on every fetch.
+    */
+    DecodedInstruction instruction;
+    if (program_counter >= PRGCodeStart &&
+        (decodedCode[program_counter - PRGCodeStart].length || decodeBlock(program_counter))) {
+#if NEMU_JIT
+        if (!traceBuffer && runCompiledBlock(budget)) {
+            return 1;
+        }
+#endif
+        instruction = decodedCode[program_counter - PRGCodeStart];
+    } else {
+        instruction = decodeInstruction(program_counter);
+    }
 
-    if (CycleLength && (execute(opcode) || executeBranch(opcode) || executeType1(opcode) || executeType2(opcode) || executeType0(opcode))) {
-        skipCycles += CycleLength;
-        std::cout << "[NEMU] INFO: Opcode : " << std::hex << opcode << std::endl;
+#if NEMU_CPU_CORE == CPUCoreThreaded
+    return runThreaded(instruction, budget);
+#else
+    uint16_t addr = beginInstruction(instruction);
+    if (execute(instruction.opcode)) {
+        endInstruction(instruction, addr);
     } else {
-        currentINSTR = "UNKN";
-        std::cout << "[NEMU] ERROR: Unknown Opcode : " << std::hex << opcode << std::endl;
+        NEMU_ERROR(LogCPU, "Unknown Opcode : %02x", instruction.opcode);
     }
-    
+    return 1;
+#endif
+}
+
+DecodedInstruction cpu::fetchInstruction() {
+    if (program_counter >= PRGCodeStart &&
+        (decodedCode[program_counter - PRGCodeStart].length || decodeBlock(program_counter))) {
+        return decodedCode[program_counter - PRGCodeStart];
+    }
+    return decodeInstruction(program_counter);
+}
+
+uint16_t cpu::beginInstruction(const DecodedInstruction& instruction) {
+    if (traceBuffer) {
+        traceInstruction(instruction.opcode);
+    }
+
+    uint16_t addr = program_counter;
+    program_counter += instruction.length;
+    decodedOperand = instruction.operand;
+    return addr;
+}
+
+void cpu::endInstruction(const DecodedInstruction& instruction, uint16_t addr) {
+    skipCycles += instruction.cycles;
+    if (program_counter <= addr && !traceBuffer) {
+        skipIdleLoop(addr);
+    }
+    NEMU_TRACE(LogCPU, "Opcode : %02x", instruction.opcode);
+}
+
+void cpu::traceInstruction(uint8_t opcode) {
+    TraceRecord& record = traceBuffer->next();
+    record.cycle = cycles - 1;
+    record.pc = program_counter;
+    record.opcode = opcode;
+    record.operand[0] = Bus->peek(program_counter + 1);
+    record.operand[1] = Bus->peek(program_counter + 2);
+    record.a = accumulator;
+    record.x = x_reg;
+    record.y = y_reg;
+    record.p = status.pack();
+    record.sp = stack_pointer;
+    record.ppuDot = Bus->getPPUFrameDot();
+}
+
+std::string cpu::disassemble(uint16_t addr) {
+    return ::disassemble(addr, Bus->peek(addr), Bus->peek(addr + 1), Bus->peek(addr + 2));
 }
 
 void cpu::interrupt(Interrupt type) {
@@ -129,337 +217,180 @@ void cpu::setPageCrossed(uint16_t a, uint16_t b, int inc) {
     }
 }
 
-bool cpu::execute(uint8_t opcode) {
-    switch (opcode) {
-        case 0xEA: // NOP
-            NOP();
-            break;
-        case 0x00: // BRK
-            BRK();
-            break;
-        case 0x20: // JSR
-            JSR();
-            break;
-        case 0x60: // RTS
-            RTS();
-            break;
-        case 0x40: // RTI
-            RTI();
-            break;
-        case 0x4C: // JMP
-            JMP();
-            break;
-        case 0x6C: // JMPI
-            JMPI();
-            break;
-        case 0x08: // PHP
-            PHP();
-            break;
-        case 0x28: // PLP
-            PLP();
-            break;
-        case 0x48: // PHA
-            PHA();
-            break;
-        case 0x68: // PLA
-            PLA();
-            break;
-        case 0x88: // DEY
-            DEY();
-            break;
-        case 0xCA: // DEX
-            DEX();
-            break;
-        case 0xa8: // TAY
-            TAY();
-            break;
-        case 0xc8: // INY
-            INY();
-            break;
-        case 0xE8: // INX
-            INX();
-            break;
-        case 0x18: // CLC
-            CLC();
-            break;
-        case 0x38: // SEC
-            SEC();
-            break;
-        case 0x58: // CLI
-            CLI();
-            break;
-        case 0x78: // SEI
-            SEI();
-            break;
-        case 0xD8: // CLD
-            CLD();
-            break;
-        case 0xF8: // SED
-            SED();
-            break;
-        case 0x98: // TYA
-            TYA();
-            break;
-        case 0xB8: // CLV
-            CLV();
-            break;
-        case 0x8A: // TXA
-            TXA();
+template<AddressingMode mode, bool pageCross>
+uint16_t cpu::fetchAddress() {
+    uint16_t location = 0;
+    if constexpr (mode == Immediate) {
+        location = program_counter - 1;
+    } else if constexpr (mode == ZeroPage) {
+        location = decodedOperand;
+    } else if constexpr (mode == ZeroPageX) {
+        location = (decodedOperand + x_reg) & 0xff;
+    } else if constexpr (mode == ZeroPageY) {
+        location = (decodedOperand + y_reg) & 0xff;
+    } else if constexpr (mode == Absolute) {
+        location = decodedOperand;
+    } else if constexpr (mode == AbsoluteX || mode == AbsoluteY) {
+        uint8_t index = mode == AbsoluteX ? x_reg : y_reg;
+        location = decodedOperand;
+        if constexpr (pageCross)
+            setPageCrossed(location, location + index);
+        location += index;
+    } else if constexpr (mode == IndirectX) {
+        uint8_t zero_addr = x_reg + decodedOperand;
+        location = Bus->read(zero_addr & 0xff) | Bus->read((zero_addr + 1) & 0xff) << 8;
+    } else if constexpr (mode == IndirectY) {
+        uint8_t zero_addr = decodedOperand;
+        location = Bus->read(zero_addr & 0xff) | Bus->read((zero_addr + 1) & 0xff) << 8;
+        if constexpr (pageCross)
+            setPageCrossed(location, location + y_reg);
+        location += y_reg;
+    } else {
+        static_assert(mode == Immediate, "Addressing mode has no operand address");
+    }
+    return location;
+}
+
+template<void (cpu::*op)(uint16_t), AddressingMode mode, bool pageCross>
+void cpu::addressed() {
+    (this->*op)(fetchAddress<mode, pageCross>());
+}
+
+template<BranchOnFlag flag, bool set>
+void cpu::branch() {
+    bool taken;
+    switch (flag) {
+        case Negative:
+            taken = status.N() == set;
             break;
-        case 0x9A: // TXS
-            TXS();
+        case Overflow:
+            taken = status.get(OverflowFlag) == set;
             break;
-        case 0xAA: // TAX
-            TAX();
+        case Carry:
+            taken = status.get(CarryFlag) == set;
             break;
-        case 0xBA: // TSX
-            TSX();
+        case Zero:
+            taken = status.Z() == set;
             break;
-        default:
-            return false;
-    };
-    return true;
+    }
+
+    if (taken) {
+        BNH();
+    }
 }
 
-bool cpu::executeBranch(uint8_t opcode) {
-    if ((opcode & 0x1F) == 0x10) {
-        bool branch = opcode & 0x20;
-
-        switch (opcode >> 6) {
-            case Negative:
-                branch = !(branch ^ status.N);
-                break;
-            case Overflow:
-                branch = !(branch ^ status.V);
-                break;
-            case Carry:
-                branch = !(branch ^ status.C);
-                break;
-            case Zero:
-                branch = !(branch ^ status.Z);
-                break;
-            default:
-                return false;
-        }
+#if NEMU_CPU_CORE == CPUCoreTable
 
-        if (branch) {
-            BNH();
-        } else {
-            ++program_counter;
-        }
-        return true;
+const std::array<cpu::Operation, 0x100> cpu::operations = [] {
+    std::array<Operation, 0x100> table{};
+#define CPU_TABLE_ENTRY(opcode, ...) table[opcode] = __VA_ARGS__;
+    CPU_OPERATIONS(CPU_TABLE_ENTRY)
+#undef CPU_TABLE_ENTRY
+    return table;
+}();
+
+bool cpu::execute(uint8_t opcode) {
+    Operation operation = operations[opcode];
+    if (!operation) {
+        return false;
     }
-    return false;
+    (this->*operation)();
+    return true;
 }
 
-bool cpu::executeType1(uint8_t opcode) {
-    if ((opcode & 0x3) == 0x1) {
-        uint16_t location = 0;
-        auto op = (opcode & 0xE0) >> 5;
-        switch ((opcode & 0x1C) >> 2) {
-            case 0: { // Indexed Indirect X
-                uint8_t zero_addr = x_reg + Bus->read(program_counter++);
-                location = Bus->read(zero_addr & 0xff) | Bus->read((zero_addr + 1) & 0xff) << 8;
-            }
-                break;
-            case 1: // ZeroPage
-                location = Bus->read(program_counter++);
-                break;
-            case 2: // Immediate
-                location = program_counter++;
-                break;
-            case 3: // Absolute
-                location = readAddr(program_counter);
-                program_counter += 2;
-                break;
-            case 4: { // Indirect Y
-                uint8_t zero_addr = Bus->read(program_counter++);
-                location = Bus->read(zero_addr & 0xff) | Bus->read((zero_addr + 1) & 0xff) << 8;
-                if (op != 4)
-                    setPageCrossed(location, location + y_reg);
-                location += y_reg;
-                }
-                break;
-            case 5: // Indexed X
-                location = (Bus->read(program_counter++) + x_reg) & 0xff;
-                break;
-            case 6: // AbsoluteY
-                location = readAddr(program_counter);
-                program_counter += 2;
-                if (op != 4)
-                    setPageCrossed(location, location + y_reg);
-                location += y_reg;
-                break;
-            case 7: // AbsoluteX
-                location = readAddr(program_counter);
-                program_counter += 2;
-                if (op != 4)
-                    setPageCrossed(location, location + x_reg);
-                location += x_reg;
-                break;
-            default:
-                return false;
-        }
+#elif NEMU_CPU_CORE == CPUCoreSwitch
 
-        switch (op) {
-            case 0x0: // ORA
-                ORA(location);
-                break;
-            case 0x1: // AND
-                AND(location);
-                break;
-            case 0x2: // EOR
-                EOR(location);
-                break;
-            case 0x3: // ADC
-                ADC(location);
-                break;
-            case 0x4: // STA
-                STA(location);
-                break;
-            case 0x5: // LDA
-                LDA(location);
-                break;
-            case 0x7: // SBC
-                SBC(location);
-                break;
-            case 0x6: // CMP
-                CMP(location);
-                break;
-            default:
-                return false;
-        }
-        return true;
+bool cpu::execute(uint8_t opcode) {
+    switch (opcode) {
+#define CPU_SWITCH_CASE(opcode, ...) case opcode: { constexpr Operation handler = __VA_ARGS__; (this->*handler)(); } return true;
+    CPU_OPERATIONS(CPU_SWITCH_CASE)
+#undef CPU_SWITCH_CASE
+    default:
+        return false;
     }
-    return false;
 }
 
-bool cpu::executeType2(uint8_t opcode) {
-    if ((opcode & 0x3) == 2) {
-        uint16_t location = 0;
-        auto op = (opcode & 0xE0) >> 5;
-        auto addr_mode = (opcode & 0x1C) >> 2;
-        switch (addr_mode) {
-            case 0x0: // Immediate
-                location = program_counter++;
-                break;
-            case 0x1: // ZeroPage
-                location = Bus->read(program_counter++);
-                break;
-            case 0x2: // Accumulator
-                break;
-            case 0x3: // Absolute
-                location = readAddr(program_counter);
-                program_counter += 2;
-                break;
-            case 0x5: // Indexed
-            {
-                location = Bus->read(program_counter++);
-                uint8_t index;
-                if (op == 0x5 || op == 0x4) {
-                    index = y_reg;
-                } else {
-                    index = x_reg;
-                }
-                location = (location + index) & 0xff;
-            }
-                break;
-            case 0x7: // Absolute Indexed
-            {
-                location = readAddr(program_counter);
-                program_counter += 2;
-                uint8_t index;
-                if (op == 0x5 || op == 0x4) {
-                    index = y_reg;
-                } else {
-                    index = x_reg;
-                }
-                setPageCrossed(location, location + index);
-                location += index;
-            }
-                break;
-            default:
-                return false;
-        }
+#else
+
+/*
+* The next instruction runs right away when it starts within budget, no interrupt is pending
+* and the PPU can fall behind by its cycles without missing an event or a catch-up. Its cycles
+* are then accounted here instead of being waited through in step() calls.
+*/
+bool cpu::chainInstruction(int& ran, int budget) {
+    if (ran - 1 + skipCycles >= budget || 3 * skipCycles > Bus->getPPUEventFreeDots() ||
+        status.pendingNMI || status.pendingIRQ) {
+        return false;
+    }
+    cycles += skipCycles;
+    ran += skipCycles;
+    Bus->deferPPU(3 * skipCycles);
+    skipCycles = 0;
+    return true;
+}
 
-        std::uint16_t operand = 0;
-        switch (op) {
-            case 0x0: // ASL
-            case 0x1: // ROL
-                ROL(location, op, addr_mode, operand);
-                break;
-            case 0x2: // LSR
-            case 0x3: // ROR
-                ROR(location, op, addr_mode, operand);
-                break;
-            case 0x4: // STX
-                STX(location, op, addr_mode, operand);
-                break;
-            case 0x5: // LDX
-                LDX(location, op, addr_mode, operand);
-                break;
-            case 0x6: // DEC
-                DEC(location, op, addr_mode, operand);
-                break;
-            case 0x7: // INC
-                INC(location, op, addr_mode, operand);
-                break;
-            default:
-                return false;
+/*
+* Direct-threaded dispatch: each handler ends with its own jump to the handler of the next
+* instruction, so the branch predictor sees one indirect jump per handler and the CPU stays
+* in this function until chainInstruction stops it.
+*/
+int cpu::runThreaded(DecodedInstruction instruction, int budget) {
+    /*
+    * Label addresses only exist inside this function. The table is filled by a statement
+    * expression in the initializer of a local static, so concurrent first calls from
+    * several emulators are serialized by the static initialization guard.
+    */
+    static void* const* const labels = ({
+        static void* table[0x100];
+        for (auto& label : table) {
+            label = &&unknown;
         }
-        return true;
+#define CPU_THREADED_LABEL(opcode, ...) table[opcode] = &&op_##opcode;
+        CPU_OPERATIONS(CPU_THREADED_LABEL)
+#undef CPU_THREADED_LABEL
+        table;
+    });
+
+    int ran = 1;
+    uint16_t addr = beginInstruction(instruction);
+    goto *labels[instruction.opcode];
+
+#define CPU_THREADED_HANDLER(code, ...) \
+    op_##code: { \
+        constexpr Operation handler = __VA_ARGS__; \
+        (this->*handler)(); \
+        endInstruction(instruction, addr); \
+        if (!chainInstruction(ran, budget)) { \
+            return ran; \
+        } \
+        instruction = fetchInstruction(); \
+        addr = beginInstruction(instruction); \
+        goto *labels[instruction.opcode]; \
     }
-    return false;
+    CPU_OPERATIONS(CPU_THREADED_HANDLER)
+#undef CPU_THREADED_HANDLER
+unknown:
+    NEMU_ERROR(LogCPU, "Unknown Opcode : %02x", instruction.opcode);
+    return ran;
 }
 
-bool cpu::executeType0(uint8_t opcode) {
-    if ((opcode & 3) == 0x0) {
-        uint16_t location = 0;
-        switch ((opcode & 0x1C) >> 2) {
-            case 0x0: // Immediate
-                location = program_counter++;
-                break;
-            case 0x1: // ZeroPage
-                location = Bus->read(program_counter++);
-                break;
-            case 0x3: // Absolute
-                location = readAddr(program_counter);
-                program_counter += 2;
-                break;
-            case 0x5: // Indexed
-                location = (Bus->read(program_counter++) + x_reg) & 0xff;
-                break;
-            case 0x7: // Absolute Indexed
-                location = readAddr(program_counter);
-                program_counter += 2;
-                setPageCrossed(location, location + x_reg);
-                location += x_reg;
-                break;
-            default:
-                return false;
-        }
-        std::uint16_t operand = 0;
-        switch ((opcode & 0xE0) >> 5) {
-            case 0x1: // BIT
-                BIT(location, operand);
-                break;
-            case 0x4: // STY
-                STY(location, operand);
-                break;
-            case 0x5: // LDY
-                LDY(location, operand);
-                break;
-            case 0x6: // CPY
-                CPY(location, operand);
-                break;
-            case 0x7: // CPX
-                CPX(location, operand);
-                break;
-            default:
-                return false;
-        }
+#endif
 
-        return true;
-    }
-    return false;
-}
\ No newline at end of file
+#if NEMU_JIT
+
+template<cpu::Operation handler>
+void cpu::compiledStep(cpu* self, uint16_t pc, uint16_t operand) {
+    self->program_counter = pc;
+    self->decodedOperand = operand;
+    (self->*handler)();
+}
+
+const std::array<Recompiler::Step, 0x100> cpu::compiledSteps = [] {
+    std::array<Recompiler::Step, 0x100> table{};
+#define CPU_COMPILED_ENTRY(opcode, ...) table[opcode] = &cpu::compiledStep<__VA_ARGS__>;
+    CPU_OPERATIONS(CPU_COMPILED_ENTRY)
+#undef CPU_COMPILED_ENTRY
+    return table;
+}();
+
+#endif
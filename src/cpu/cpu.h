@@ -3,21 +3,109 @@
 #include <memory>
 #include <string>
 #include <iomanip>
+#include <array>
+#include <vector>
 #include "../bus/bus.h"
+#include "../log/log.h"
+#include "../trace/trace.h"
+#include "../state/state.h"
+#include "disassembler.h"
+#include "recompiler.h"
+#include "cpuoperations.h"
+
+/*
+* Opcode dispatch, chosen at build time through NEMU_CPU_CORE. All cores expand CPU_OPERATIONS.
+* CPUCoreThreaded, the default, is direct-threaded: every handler dispatches the next instruction
+* itself through computed goto, see cpu::runThreaded. It needs GCC or Clang, other compilers get
+* CPUCoreSwitch, which runs one instruction per step(). CPUCoreTable calls through the operation table.
+*/
+#define CPUCoreTable 0
+#define CPUCoreSwitch 1
+#define CPUCoreThreaded 2
+
+#ifndef NEMU_CPU_CORE
+#define NEMU_CPU_CORE CPUCoreThreaded
+#endif
+
+#if NEMU_CPU_CORE == CPUCoreThreaded && !defined(__GNUC__)
+#undef NEMU_CPU_CORE
+#define NEMU_CPU_CORE CPUCoreSwitch
+#endif
+
+/*
+* NEMU_JIT runs hot PRG-ROM blocks through the recompiler, see recompiler.h.
+*/
+#ifndef NEMU_JIT
+#define NEMU_JIT 0
+#endif
+
+#if NEMU_JIT && !(defined(__x86_64__) && defined(__unix__))
+#error "NEMU_JIT needs an x86-64 host with mmap"
+#endif
+
+/*
+* A block is compiled after JitHotThreshold runs. JitPenaltyCycles bounds the page crossing
+* and branch cycles one instruction can add on top of its base cycles.
+*/
+#define JitHotThreshold 16
+#define JitNotCompilable 0xffff
+#define JitPenaltyCycles 3
 
 #define STACK_STARTING_POINTER 0xFF
 #define NMIVector 0xfffa
 #define IRQVector 0xfffe
 
+/*
+* P register bits
+*/
+#define CarryFlag 0x01
+#define ZeroFlag 0x02
+#define InterruptFlag 0x04
+#define DecimalFlag 0x08
+#define BreakFlag 0x10
+#define UnusedFlag 0x20
+#define OverflowFlag 0x40
+#define NegativeFlag 0x80
+
+/*
+* The P register, kept packed. N and Z are not stored: setZN only records the last result
+* and they are derived when a branch, PHP or an interrupt reads them. Z is set when the low
+* byte of result is 0, N when bit 7 or 8 is set (bit 8 lets a pulled P byte set both).
+*/
 struct Status {
-    bool C;
-    bool Z;
-    bool I;
-    bool D;
-    bool V;
-    bool N;
+    uint8_t flags;
+    uint16_t result;
     bool pendingNMI;
     bool pendingIRQ;
+
+    bool get(uint8_t flag) const {
+        return flags & flag;
+    }
+
+    void set(uint8_t flag, bool value) {
+        flags = (flags & ~flag) | (-uint8_t(value) & flag);
+    }
+
+    uint8_t carry() const {
+        return flags & CarryFlag;
+    }
+
+    bool N() const {
+        return result & 0x180;
+    }
+
+    bool Z() const {
+        return !(result & 0xff);
+    }
+
+    uint8_t pack() const {
+        return (flags & (OverflowFlag | DecimalFlag | InterruptFlag | CarryFlag)) | UnusedFlag | N() << 7 | Z() << 1;
+    }
+
+    void unpack(uint8_t p) {
+        flags = p;
+        result = ((p & ZeroFlag) ? 0 : 1) | (p & NegativeFlag) << 1;
+    }
 };
 
 enum Interrupt {
@@ -55,13 +143,52 @@ enum BranchOnFlag {
     Zero
 };
 
+/*
+* Addressing modes, bound to each opcode at compile time through the operation table.
+*/
+enum AddressingMode {
+    Implied,
+    Accumulator,
+    Immediate,
+    ZeroPage,
+    ZeroPageX,
+    ZeroPageY,
+    Absolute,
+    AbsoluteX,
+    AbsoluteY,
+    IndirectX,
+    IndirectY
+};
+
 const auto ResetVector = 0xfffc;
 
+/*
+* Code at or above PRGCodeStart that is mapped straight to PRG-ROM is decoded once and cached.
+*/
+#define PRGCodeStart 0x8000
+
+/*
+* One decoded instruction: handlers take their operand from here instead of fetching it.
+* length is 0 for cache entries that have not been decoded.
+*/
+struct DecodedInstruction {
+    uint16_t operand;
+    uint8_t opcode;
+    uint8_t length;
+    uint8_t cycles;
+};
+
 class cpu {
 public:
-    cpu(std::shared_ptr<bus> pBus);
+    cpu(bus& mainBus);
 
-    void step();
+    /*
+    * Runs the next CPU cycle. budget is the number of cycles the caller is going to run, this one
+    * included: cores that run ahead may use all of them, but no instruction starting at or past
+    * budget runs. Returns the cycles run, after which the state is the same as after as many
+    * single cycle steps.
+    */
+    int step(int budget = 1);
     void reset(uint16_t start_addr);
     void reset();
     void interrupt(Interrupt type);
@@ -70,13 +197,95 @@ public:
         skipCycles += 513;
         skipCycles += (cycles & 1);
     }
+
+    /*
+    * Cycles the CPU only waits through: the rest of an instruction, a DMA or a skipped idle loop.
+    * skipIdleCycles(count) has the same effect as count calls to step().
+    */
+    int idleCycles() const {
+        return skipCycles > 1 ? skipCycles - 1 : 0;
+    }
+
+    void skipIdleCycles(int count) {
+        cycles += count;
+        skipCycles -= count;
+    }
     
     uint16_t getProgramCounter() {
         return program_counter;
     }
 
+    /*
+    * Decodes the instruction at addr without side effects, e.g. disassemble(getProgramCounter()).
+    */
+    std::string disassemble(uint16_t addr);
+
+    /*
+    * Records every instruction into buffer, nullptr turns tracing off.
+    */
+    void setTraceBuffer(std::shared_ptr<TraceBuffer> buffer) {
+        traceBuffer = buffer;
+    }
+
+    /*
+    * Save state section: registers and cycle counters. Decoded and compiled code is not
+    * saved, it stays valid as long as the PRG banks are restored through the mapper.
+    */
+    void saveState(StateWriter& state) const;
+    void loadState(StateReader& state);
+
 private:
     void InterruptSeq(Interrupt type);
+    void traceInstruction(uint8_t opcode);
+
+    /*
+    * The parts of running an instruction every core shares: beginInstruction traces it, moves
+    * program_counter past it and returns its address, endInstruction accounts its cycles.
+    */
+    DecodedInstruction fetchInstruction();
+    uint16_t beginInstruction(const DecodedInstruction& instruction);
+    void endInstruction(const DecodedInstruction& instruction, uint16_t addr);
+
+    /*
+    * Decodes the straight-line block starting at addr into decodedCode, up to the next
+    * jump, branch or page end. False when addr is not directly mapped PRG-ROM.
+    */
+    bool decodeBlock(uint16_t addr);
+    DecodedInstruction decodeInstruction(uint16_t addr);
+    void invalidateCode(uint8_t page);
+    static bool endsBlock(uint8_t opcode);
+
+    /*
+    * Idle loops spin until the next PPU event (vblank NMI, frame end) changes what they poll:
+    * JMP * or a load of RAM or PPUSTATUS branching straight back to itself. skipIdleLoop runs
+    * after jump jumped back to program_counter and adds every iteration that ends before the
+    * next event to skipCycles, the iterations it skips cannot change the machine state.
+    */
+    bool idleLoop(uint16_t head, uint16_t jump);
+    void skipIdleLoop(uint16_t jump);
+
+#if NEMU_JIT
+    struct CompiledBlock {
+        Recompiler::Block code;
+        uint16_t maxCycles;
+        uint16_t heat;
+    };
+
+    /*
+    * Runs the compiled block at program_counter, false when the interpreter has to step instead:
+    * the block is cold, not compilable, or could run past the next PPU event or the step budget.
+    * Within the budget every instruction of the block starts before the caller stops, so the
+    * state it leaves is the one the interpreter would leave.
+    */
+    bool runCompiledBlock(int budget);
+    void compileBlock(uint16_t addr, CompiledBlock& block);
+    bool compilable(const DecodedInstruction& instruction);
+    bool plainMemory(uint32_t addr, bool write);
+
+    template<void (cpu::*handler)()>
+    static void compiledStep(cpu* self, uint16_t pc, uint16_t operand);
+    static const std::array<Recompiler::Step, 0x100> compiledSteps;
+#endif
     void pushStack(uint8_t val);
     
     uint16_t readAddr(uint16_t addr);
@@ -85,11 +294,38 @@ private:
     void setZN(uint8_t value);
     void setPageCrossed(uint16_t a, uint16_t b, int inc = 1);
 
+    using Operation = void (cpu::*)();
+
+    template<AddressingMode mode, bool pageCross = true>
+    uint16_t fetchAddress();
+
+    template<void (cpu::*op)(uint16_t), AddressingMode mode, bool pageCross = true>
+    void addressed();
+
+    template<BranchOnFlag flag, bool set>
+    void branch();
+
+#if NEMU_CPU_CORE == CPUCoreThreaded
+    /*
+    * Runs instruction and chains to the following ones within budget, returns the cycles run.
+    */
+    int runThreaded(DecodedInstruction instruction, int budget);
+    bool chainInstruction(int& ran, int budget);
+#else
+    /*
+    * Runs the handler of opcode, false for unsupported opcodes.
+    */
     bool execute(uint8_t opcode);
-    bool executeBranch(uint8_t opcode);
-    bool executeType1(uint8_t opcode);
-    bool executeType2(uint8_t opcode);
-    bool executeType0(uint8_t opcode);
+#endif
+
+#if NEMU_CPU_CORE == CPUCoreTable
+    /*
+    * One handler per opcode, nullptr for unsupported opcodes.
+    */
+    static const std::array<Operation, 0x100> operations;
+#endif
+
+    static const std::array<bool, 0x100> implemented;
 
     void NOP();
     void BRK();
@@ -128,17 +364,23 @@ private:
     void LDA(uint16_t loc);
     void SBC(uint16_t loc);
     void CMP(uint16_t loc);
-    void ROL(uint16_t loc, int op, int addr_mode, uint16_t operand);
-    void ROR(uint16_t loc, int op, int addr_mode, uint16_t operand);
-    void STX(uint16_t loc, int op, int addr_mode, uint16_t operand);
-    void LDX(uint16_t loc, int op, int addr_mode, uint16_t operand);
-    void DEC(uint16_t loc, int op, int addr_mode, uint16_t operand);
-    void INC(uint16_t loc, int op, int addr_mode, uint16_t operand);
-    void BIT(uint16_t loc, uint16_t operand);
-    void STY(uint16_t loc, uint16_t operand);
-    void LDY(uint16_t loc, uint16_t operand);
-    void CPY(uint16_t loc, uint16_t operand);
-    void CPX(uint16_t loc, uint16_t operand);
+    void ASL(uint16_t loc);
+    void ASLA();
+    void ROL(uint16_t loc);
+    void ROLA();
+    void LSR(uint16_t loc);
+    void LSRA();
+    void ROR(uint16_t loc);
+    void RORA();
+    void STX(uint16_t loc);
+    void LDX(uint16_t loc);
+    void DEC(uint16_t loc);
+    void INC(uint16_t loc);
+    void BIT(uint16_t loc);
+    void STY(uint16_t loc);
+    void LDY(uint16_t loc);
+    void CPY(uint16_t loc);
+    void CPX(uint16_t loc);
 
     uint8_t accumulator;
     uint8_t x_reg;
@@ -146,8 +388,16 @@ private:
     Status status;
     uint8_t stack_pointer;
     uint16_t program_counter;
+    uint16_t decodedOperand;
     int skipCycles;
     int cycles;
-    std::shared_ptr<bus> Bus;
-    std::string currentINSTR;
+    bus* Bus;
+    std::shared_ptr<TraceBuffer> traceBuffer;
+
+    std::vector<DecodedInstruction> decodedCode;
+
+#if NEMU_JIT
+    Recompiler recompiler;
+    std::vector<CompiledBlock> compiledCode;
+#endif
 };
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+/*
+* Every implemented opcode with its handler, expanded by each CPU core
+* (operation table, switch or computed goto). Handlers are member function
+* pointers, so X is variadic to keep template argument commas together.
+*/
+#define CPU_OPERATIONS(X) \
+    /*                                                    \
+    * Implied                                             \
+    */                                                    \
+    X(0xEA, &cpu::NOP)                                    \
+    X(0x00, &cpu::BRK)                                    \
+    X(0x20, &cpu::JSR)                                    \
+    X(0x60, &cpu::RTS)                                    \
+    X(0x40, &cpu::RTI)                                    \
+    X(0x4C, &cpu::JMP)                                    \
+    X(0x6C, &cpu::JMPI)                                   \
+    X(0x08, &cpu::PHP)                                    \
+    X(0x28, &cpu::PLP)                                    \
+    X(0x48, &cpu::PHA)                                    \
+    X(0x68, &cpu::PLA)                                    \
+    X(0x88, &cpu::DEY)                                    \
+    X(0xCA, &cpu::DEX)                                    \
+    X(0xA8, &cpu::TAY)                                    \
+    X(0xC8, &cpu::INY)                                    \
+    X(0xE8, &cpu::INX)                                    \
+    X(0x18, &cpu::CLC)                                    \
+    X(0x38, &cpu::SEC)                                    \
+    X(0x58, &cpu::CLI)                                    \
+    X(0x78, &cpu::SEI)                                    \
+    X(0xD8, &cpu::CLD)                                    \
+    X(0xF8, &cpu::SED)                                    \
+    X(0x98, &cpu::TYA)                                    \
+    X(0xB8, &cpu::CLV)                                    \
+    X(0x8A, &cpu::TXA)                                    \
+    X(0x9A, &cpu::TXS)                                    \
+    X(0xAA, &cpu::TAX)                                    \
+    X(0xBA, &cpu::TSX)                                    \
+                                                          \
+    /*                                                    \
+    * Branches                                            \
+    */                                                    \
+    X(0x10, &cpu::branch<Negative, false>) /* BPL */      \
+    X(0x30, &cpu::branch<Negative, true>) /* BMI */       \
+    X(0x50, &cpu::branch<Overflow, false>) /* BVC */      \
+    X(0x70, &cpu::branch<Overflow, true>) /* BVS */       \
+    X(0x90, &cpu::branch<Carry, false>) /* BCC */         \
+    X(0xB0, &cpu::branch<Carry, true>) /* BCS */          \
+    X(0xD0, &cpu::branch<Zero, false>) /* BNE */          \
+    X(0xF0, &cpu::branch<Zero, true>) /* BEQ */           \
+                                                          \
+    /*                                                    \
+    * ORA, AND, EOR, ADC, STA, LDA, CMP, SBC              \
+    */                                                    \
+    X(0x01, &cpu::addressed<&cpu::ORA, IndirectX>)        \
+    X(0x05, &cpu::addressed<&cpu::ORA, ZeroPage>)         \
+    X(0x09, &cpu::addressed<&cpu::ORA, Immediate>)        \
+    X(0x0D, &cpu::addressed<&cpu::ORA, Absolute>)         \
+    X(0x11, &cpu::addressed<&cpu::ORA, IndirectY>)        \
+    X(0x15, &cpu::addressed<&cpu::ORA, ZeroPageX>)        \
+    X(0x19, &cpu::addressed<&cpu::ORA, AbsoluteY>)        \
+    X(0x1D, &cpu::addressed<&cpu::ORA, AbsoluteX>)        \
+                                                          \
+    X(0x21, &cpu::addressed<&cpu::AND, IndirectX>)        \
+    X(0x25, &cpu::addressed<&cpu::AND, ZeroPage>)         \
+    X(0x29, &cpu::addressed<&cpu::AND, Immediate>)        \
+    X(0x2D, &cpu::addressed<&cpu::AND, Absolute>)         \
+    X(0x31, &cpu::addressed<&cpu::AND, IndirectY>)        \
+    X(0x35, &cpu::addressed<&cpu::AND, ZeroPageX>)        \
+    X(0x39, &cpu::addressed<&cpu::AND, AbsoluteY>)        \
+    X(0x3D, &cpu::addressed<&cpu::AND, AbsoluteX>)        \
+                                                          \
+    X(0x41, &cpu::addressed<&cpu::EOR, IndirectX>)        \
+    X(0x45, &cpu::addressed<&cpu::EOR, ZeroPage>)         \
+    X(0x49, &cpu::addressed<&cpu::EOR, Immediate>)        \
+    X(0x4D, &cpu::addressed<&cpu::EOR, Absolute>)         \
+    X(0x51, &cpu::addressed<&cpu::EOR, IndirectY>)        \
+    X(0x55, &cpu::addressed<&cpu::EOR, ZeroPageX>)        \
+    X(0x59, &cpu::addressed<&cpu::EOR, AbsoluteY>)        \
+    X(0x5D, &cpu::addressed<&cpu::EOR, AbsoluteX>)        \
+                                                          \
+    X(0x61, &cpu::addressed<&cpu::ADC, IndirectX>)        \
+    X(0x65, &cpu::addressed<&cpu::ADC, ZeroPage>)         \
+    X(0x69, &cpu::addressed<&cpu::ADC, Immediate>)        \
+    X(0x6D, &cpu::addressed<&cpu::ADC, Absolute>)         \
+    X(0x71, &cpu::addressed<&cpu::ADC, IndirectY>)        \
+    X(0x75, &cpu::addressed<&cpu::ADC, ZeroPageX>)        \
+    X(0x79, &cpu::addressed<&cpu::ADC, AbsoluteY>)        \
+    X(0x7D, &cpu::addressed<&cpu::ADC, AbsoluteX>)        \
+                                                          \
+    X(0x81, &cpu::addressed<&cpu::STA, IndirectX>)        \
+    X(0x85, &cpu::addressed<&cpu::STA, ZeroPage>)         \
+    X(0x8D, &cpu::addressed<&cpu::STA, Absolute>)         \
+    X(0x91, &cpu::addressed<&cpu::STA, IndirectY, false>) \
+    X(0x95, &cpu::addressed<&cpu::STA, ZeroPageX>)        \
+    X(0x99, &cpu::addressed<&cpu::STA, AbsoluteY, false>) \
+    X(0x9D, &cpu::addressed<&cpu::STA, AbsoluteX, false>) \
+                                                          \
+    X(0xA1, &cpu::addressed<&cpu::LDA, IndirectX>)        \
+    X(0xA5, &cpu::addressed<&cpu::LDA, ZeroPage>)         \
+    X(0xA9, &cpu::addressed<&cpu::LDA, Immediate>)        \
+    X(0xAD, &cpu::addressed<&cpu::LDA, Absolute>)         \
+    X(0xB1, &cpu::addressed<&cpu::LDA, IndirectY>)        \
+    X(0xB5, &cpu::addressed<&cpu::LDA, ZeroPageX>)        \
+    X(0xB9, &cpu::addressed<&cpu::LDA, AbsoluteY>)        \
+    X(0xBD, &cpu::addressed<&cpu::LDA, AbsoluteX>)        \
+                                                          \
+    X(0xC1, &cpu::addressed<&cpu::CMP, IndirectX>)        \
+    X(0xC5, &cpu::addressed<&cpu::CMP, ZeroPage>)         \
+    X(0xC9, &cpu::addressed<&cpu::CMP, Immediate>)        \
+    X(0xCD, &cpu::addressed<&cpu::CMP, Absolute>)         \
+    X(0xD1, &cpu::addressed<&cpu::CMP, IndirectY>)        \
+    X(0xD5, &cpu::addressed<&cpu::CMP, ZeroPageX>)        \
+    X(0xD9, &cpu::addressed<&cpu::CMP, AbsoluteY>)        \
+    X(0xDD, &cpu::addressed<&cpu::CMP, AbsoluteX>)        \
+                                                          \
+    X(0xE1, &cpu::addressed<&cpu::SBC, IndirectX>)        \
+    X(0xE5, &cpu::addressed<&cpu::SBC, ZeroPage>)         \
+    X(0xE9, &cpu::addressed<&cpu::SBC, Immediate>)        \
+    X(0xED, &cpu::addressed<&cpu::SBC, Absolute>)         \
+    X(0xF1, &cpu::addressed<&cpu::SBC, IndirectY>)        \
+    X(0xF5, &cpu::addressed<&cpu::SBC, ZeroPageX>)        \
+    X(0xF9, &cpu::addressed<&cpu::SBC, AbsoluteY>)        \
+    X(0xFD, &cpu::addressed<&cpu::SBC, AbsoluteX>)        \
+                                                          \
+    /*                                                    \
+    * ASL, ROL, LSR, ROR, STX, LDX, DEC, INC              \
+    */                                                    \
+    X(0x0A, &cpu::ASLA)                                   \
+    X(0x06, &cpu::addressed<&cpu::ASL, ZeroPage>)         \
+    X(0x0E, &cpu::addressed<&cpu::ASL, Absolute>)         \
+    X(0x16, &cpu::addressed<&cpu::ASL, ZeroPageX>)        \
+    X(0x1E, &cpu::addressed<&cpu::ASL, AbsoluteX>)        \
+                                                          \
+    X(0x2A, &cpu::ROLA)                                   \
+    X(0x26, &cpu::addressed<&cpu::ROL, ZeroPage>)         \
+    X(0x2E, &cpu::addressed<&cpu::ROL, Absolute>)         \
+    X(0x36, &cpu::addressed<&cpu::ROL, ZeroPageX>)        \
+    X(0x3E, &cpu::addressed<&cpu::ROL, AbsoluteX>)        \
+                                                          \
+    X(0x4A, &cpu::LSRA)                                   \
+    X(0x46, &cpu::addressed<&cpu::LSR, ZeroPage>)         \
+    X(0x4E, &cpu::addressed<&cpu::LSR, Absolute>)         \
+    X(0x56, &cpu::addressed<&cpu::LSR, ZeroPageX>)        \
+    X(0x5E, &cpu::addressed<&cpu::LSR, AbsoluteX>)        \
+                                                          \
+    X(0x6A, &cpu::RORA)                                   \
+    X(0x66, &cpu::addressed<&cpu::ROR, ZeroPage>)         \
+    X(0x6E, &cpu::addressed<&cpu::ROR, Absolute>)         \
+    X(0x76, &cpu::addressed<&cpu::ROR, ZeroPageX>)        \
+    X(0x7E, &cpu::addressed<&cpu::ROR, AbsoluteX>)        \
+                                                          \
+    X(0x86, &cpu::addressed<&cpu::STX, ZeroPage>)         \
+    X(0x8E, &cpu::addressed<&cpu::STX, Absolute>)         \
+    X(0x96, &cpu::addressed<&cpu::STX, ZeroPageY>)        \
+                                                          \
+    X(0xA2, &cpu::addressed<&cpu::LDX, Immediate>)        \
+    X(0xA6, &cpu::addressed<&cpu::LDX, ZeroPage>)         \
+    X(0xAE, &cpu::addressed<&cpu::LDX, Absolute>)         \
+    X(0xB6, &cpu::addressed<&cpu::LDX, ZeroPageY>)        \
+    X(0xBE, &cpu::addressed<&cpu::LDX, AbsoluteY>)        \
+                                                          \
+    X(0xC6, &cpu::addressed<&cpu::DEC, ZeroPage>)         \
+    X(0xCE, &cpu::addressed<&cpu::DEC, Absolute>)         \
+    X(0xD6, &cpu::addressed<&cpu::DEC, ZeroPageX>)        \
+    X(0xDE, &cpu::addressed<&cpu::DEC, AbsoluteX>)        \
+                                                          \
+    X(0xE6, &cpu::addressed<&cpu::INC, ZeroPage>)         \
+    X(0xEE, &cpu::addressed<&cpu::INC, Absolute>)         \
+    X(0xF6, &cpu::addressed<&cpu::INC, ZeroPageX>)        \
+    X(0xFE, &cpu::addressed<&cpu::INC, AbsoluteX>)        \
+                                                          \
+    /*                                                    \
+    * BIT, STY, LDY, CPY, CPX                             \
+    */                                                    \
+    X(0x24, &cpu::addressed<&cpu::BIT, ZeroPage>)         \
+    X(0x2C, &cpu::addressed<&cpu::BIT, Absolute>)         \
+                                                          \
+    X(0x84, &cpu::addressed<&cpu::STY, ZeroPage>)         \
+    X(0x8C, &cpu::addressed<&cpu::STY, Absolute>)         \
+    X(0x94, &cpu::addressed<&cpu::STY, ZeroPageX>)        \
+                                                          \
+    X(0xA0, &cpu::addressed<&cpu::LDY, Immediate>)        \
+    X(0xA4, &cpu::addressed<&cpu::LDY, ZeroPage>)         \
+    X(0xAC, &cpu::addressed<&cpu::LDY, Absolute>)         \
+    X(0xB4, &cpu::addressed<&cpu::LDY, ZeroPageX>)        \
+    X(0xBC, &cpu::addressed<&cpu::LDY, AbsoluteX>)        \
+                                                          \
+    X(0xC0, &cpu::addressed<&cpu::CPY, Immediate>)        \
+    X(0xC4, &cpu::addressed<&cpu::CPY, ZeroPage>)         \
+    X(0xCC, &cpu::addressed<&cpu::CPY, Absolute>)         \
+                                                          \
+    X(0xE0, &cpu::addressed<&cpu::CPX, Immediate>)        \
+    X(0xE4, &cpu::addressed<&cpu::CPX, ZeroPage>)         \
+    X(0xEC, &cpu::addressed<&cpu::CPX, Absolute>)
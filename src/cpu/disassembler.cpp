@@ -0,0 +1,115 @@
+#include "disassembler.h"
+#include <cstdio>
+
+static const OpcodeInfo opcodeTable[0x100] = {
+    {"BRK", OperandNone}, {"ORA", OperandIndirectX}, {"???", OperandNone}, {"???", OperandNone}, // 00
+    {"???", OperandNone}, {"ORA", OperandZeroPage}, {"ASL", OperandZeroPage}, {"???", OperandNone}, // 04
+    {"PHP", OperandNone}, {"ORA", OperandImmediate}, {"ASL", OperandAccumulator}, {"???", OperandNone}, // 08
+    {"???", OperandNone}, {"ORA", OperandAbsolute}, {"ASL", OperandAbsolute}, {"???", OperandNone}, // 0C
+    {"BPL", OperandRelative}, {"ORA", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // 10
+    {"???", OperandNone}, {"ORA", OperandZeroPageX}, {"ASL", OperandZeroPageX}, {"???", OperandNone}, // 14
+    {"CLC", OperandNone}, {"ORA", OperandAbsoluteY}, {"???", OperandNone}, {"???", OperandNone}, // 18
+    {"???", OperandNone}, {"ORA", OperandAbsoluteX}, {"ASL", OperandAbsoluteX}, {"???", OperandNone}, // 1C
+    {"JSR", OperandAbsolute}, {"AND", OperandIndirectX}, {"???", OperandNone}, {"???", OperandNone}, // 20
+    {"BIT", OperandZeroPage}, {"AND", OperandZeroPage}, {"ROL", OperandZeroPage}, {"???", OperandNone}, // 24
+    {"PLP", OperandNone}, {"AND", OperandImmediate}, {"ROL", OperandAccumulator}, {"???", OperandNone}, // 28
+    {"BIT", OperandAbsolute}, {"AND", OperandAbsolute}, {"ROL", OperandAbsolute}, {"???", OperandNone}, // 2C
+    {"BMI", OperandRelative}, {"AND", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // 30
+    {"???", OperandNone}, {"AND", OperandZeroPageX}, {"ROL", OperandZeroPageX}, {"???", OperandNone}, // 34
+    {"SEC", OperandNone}, {"AND", OperandAbsoluteY}, {"???", OperandNone}, {"???", OperandNone}, // 38
+    {"???", OperandNone}, {"AND", OperandAbsoluteX}, {"ROL", OperandAbsoluteX}, {"???", OperandNone}, // 3C
+    {"RTI", OperandNone}, {"EOR", OperandIndirectX}, {"???", OperandNone}, {"???", OperandNone}, // 40
+    {"???", OperandNone}, {"EOR", OperandZeroPage}, {"LSR", OperandZeroPage}, {"???", OperandNone}, // 44
+    {"PHA", OperandNone}, {"EOR", OperandImmediate}, {"LSR", OperandAccumulator}, {"???", OperandNone}, // 48
+    {"JMP", OperandAbsolute}, {"EOR", OperandAbsolute}, {"LSR", OperandAbsolute}, {"???", OperandNone}, // 4C
+    {"BVC", OperandRelative}, {"EOR", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // 50
+    {"???", OperandNone}, {"EOR", OperandZeroPageX}, {"LSR", OperandZeroPageX}, {"???", OperandNone}, // 54
+    {"CLI", OperandNone}, {"EOR", OperandAbsoluteY}, {"???", OperandNone}, {"???", OperandNone}, // 58
+    {"???", OperandNone}, {"EOR", OperandAbsoluteX}, {"LSR", OperandAbsoluteX}, {"???", OperandNone}, // 5C
+    {"RTS", OperandNone}, {"ADC", OperandIndirectX}, {"???", OperandNone}, {"???", OperandNone}, // 60
+    {"???", OperandNone}, {"ADC", OperandZeroPage}, {"ROR", OperandZeroPage}, {"???", OperandNone}, // 64
+    {"PLA", OperandNone}, {"ADC", OperandImmediate}, {"ROR", OperandAccumulator}, {"???", OperandNone}, // 68
+    {"JMP", OperandIndirect}, {"ADC", OperandAbsolute}, {"ROR", OperandAbsolute}, {"???", OperandNone}, // 6C
+    {"BVS", OperandRelative}, {"ADC", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // 70
+    {"???", OperandNone}, {"ADC", OperandZeroPageX}, {"ROR", OperandZeroPageX}, {"???", OperandNone}, // 74
+    {"SEI", OperandNone}, {"ADC", OperandAbsoluteY}, {"???", OperandNone}, {"???", OperandNone}, // 78
+    {"???", OperandNone}, {"ADC", OperandAbsoluteX}, {"ROR", OperandAbsoluteX}, {"???", OperandNone}, // 7C
+    {"???", OperandNone}, {"STA", OperandIndirectX}, {"???", OperandNone}, {"???", OperandNone}, // 80
+    {"STY", OperandZeroPage}, {"STA", OperandZeroPage}, {"STX", OperandZeroPage}, {"???", OperandNone}, // 84
+    {"DEY", OperandNone}, {"???", OperandNone}, {"TXA", OperandNone}, {"???", OperandNone}, // 88
+    {"STY", OperandAbsolute}, {"STA", OperandAbsolute}, {"STX", OperandAbsolute}, {"???", OperandNone}, // 8C
+    {"BCC", OperandRelative}, {"STA", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // 90
+    {"STY", OperandZeroPageX}, {"STA", OperandZeroPageX}, {"STX", OperandZeroPageY}, {"???", OperandNone}, // 94
+    {"TYA", OperandNone}, {"STA", OperandAbsoluteY}, {"TXS", OperandNone}, {"???", OperandNone}, // 98
+    {"???", OperandNone}, {"STA", OperandAbsoluteX}, {"???", OperandNone}, {"???", OperandNone}, // 9C
+    {"LDY", OperandImmediate}, {"LDA", OperandIndirectX}, {"LDX", OperandImmediate}, {"???", OperandNone}, // A0
+    {"LDY", OperandZeroPage}, {"LDA", OperandZeroPage}, {"LDX", OperandZeroPage}, {"???", OperandNone}, // A4
+    {"TAY", OperandNone}, {"LDA", OperandImmediate}, {"TAX", OperandNone}, {"???", OperandNone}, // A8
+    {"LDY", OperandAbsolute}, {"LDA", OperandAbsolute}, {"LDX", OperandAbsolute}, {"???", OperandNone}, // AC
+    {"BCS", OperandRelative}, {"LDA", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // B0
+    {"LDY", OperandZeroPageX}, {"LDA", OperandZeroPageX}, {"LDX", OperandZeroPageY}, {"???", OperandNone}, // B4
+    {"CLV", OperandNone}, {"LDA", OperandAbsoluteY}, {"TSX", OperandNone}, {"???", OperandNone}, // B8
+    {"LDY", OperandAbsoluteX}, {"LDA", OperandAbsoluteX}, {"LDX", OperandAbsoluteY}, {"???", OperandNone}, // BC
+    {"CPY", OperandImmediate}, {"CMP", OperandIndirectX}, {"???", OperandNone}, {"???", OperandNone}, // C0
+    {"CPY", OperandZeroPage}, {"CMP", OperandZeroPage}, {"DEC", OperandZeroPage}, {"???", OperandNone}, // C4
+    {"INY", OperandNone}, {"CMP", OperandImmediate}, {"DEX", OperandNone}, {"???", OperandNone}, // C8
+    {"CPY", OperandAbsolute}, {"CMP", OperandAbsolute}, {"DEC", OperandAbsolute}, {"???", OperandNone}, // CC
+    {"BNE", OperandRelative}, {"CMP", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // D0
+    {"???", OperandNone}, {"CMP", OperandZeroPageX}, {"DEC", OperandZeroPageX}, {"???", OperandNone}, // D4
+    {"CLD", OperandNone}, {"CMP", OperandAbsoluteY}, {"???", OperandNone}, {"???", OperandNone}, // D8
+    {"???", OperandNone}, {"CMP", OperandAbsoluteX}, {"DEC", OperandAbsoluteX}, {"???", OperandNone}, // DC
+    {"CPX", OperandImmediate}, {"SBC", OperandIndirectX}, {"???", OperandNone}, {"???", OperandNone}, // E0
+    {"CPX", OperandZeroPage}, {"SBC", OperandZeroPage}, {"INC", OperandZeroPage}, {"???", OperandNone}, // E4
+    {"INX", OperandNone}, {"SBC", OperandImmediate}, {"NOP", OperandNone}, {"???", OperandNone}, // E8
+    {"CPX", OperandAbsolute}, {"SBC", OperandAbsolute}, {"INC", OperandAbsolute}, {"???", OperandNone}, // EC
+    {"BEQ", OperandRelative}, {"SBC", OperandIndirectY}, {"???", OperandNone}, {"???", OperandNone}, // F0
+    {"???", OperandNone}, {"SBC", OperandZeroPageX}, {"INC", OperandZeroPageX}, {"???", OperandNone}, // F4
+    {"SED", OperandNone}, {"SBC", OperandAbsoluteY}, {"???", OperandNone}, {"???", OperandNone}, // F8
+    {"???", OperandNone}, {"SBC", OperandAbsoluteX}, {"INC", OperandAbsoluteX}, {"???", OperandNone}, // FC
+};
+
+const OpcodeInfo& opcodeInfo(uint8_t opcode) {
+    return opcodeTable[opcode];
+}
+
+int instructionLength(uint8_t opcode) {
+    switch (opcodeTable[opcode].format) {
+    case OperandNone:
+    case OperandAccumulator:
+        return 1;
+    case OperandAbsolute:
+    case OperandAbsoluteX:
+    case OperandAbsoluteY:
+    case OperandIndirect:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+std::string disassemble(uint16_t pc, uint8_t opcode, uint8_t lo, uint8_t hi) {
+    const OpcodeInfo& info = opcodeTable[opcode];
+    uint16_t word = lo | hi << 8;
+
+    char operand[16] = "";
+    switch (info.format) {
+    case OperandNone:        break;
+    case OperandAccumulator: std::snprintf(operand, sizeof(operand), "A"); break;
+    case OperandImmediate:   std::snprintf(operand, sizeof(operand), "#$%02X", lo); break;
+    case OperandZeroPage:    std::snprintf(operand, sizeof(operand), "$%02X", lo); break;
+    case OperandZeroPageX:   std::snprintf(operand, sizeof(operand), "$%02X,X", lo); break;
+    case OperandZeroPageY:   std::snprintf(operand, sizeof(operand), "$%02X,Y", lo); break;
+    case OperandAbsolute:    std::snprintf(operand, sizeof(operand), "$%04X", word); break;
+    case OperandAbsoluteX:   std::snprintf(operand, sizeof(operand), "$%04X,X", word); break;
+    case OperandAbsoluteY:   std::snprintf(operand, sizeof(operand), "$%04X,Y", word); break;
+    case OperandIndirect:    std::snprintf(operand, sizeof(operand), "($%04X)", word); break;
+    case OperandIndirectX:   std::snprintf(operand, sizeof(operand), "($%02X,X)", lo); break;
+    case OperandIndirectY:   std::snprintf(operand, sizeof(operand), "($%02X),Y", lo); break;
+    case OperandRelative:    std::snprintf(operand, sizeof(operand), "$%04X", uint16_t(pc + 2 + int8_t(lo))); break;
+    }
+
+    if (info.format == OperandNone) {
+        return info.mnemonic;
+    }
+    return std::string(info.mnemonic) + " " + operand;
+}
\ No newline at end of file
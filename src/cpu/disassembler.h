@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/*
+* Decodes opcodes on demand for debuggers and trace output, the CPU itself keeps no
+* per-instruction names.
+*/
+enum OperandFormat {
+    OperandNone,
+    OperandAccumulator,
+    OperandImmediate,
+    OperandZeroPage,
+    OperandZeroPageX,
+    OperandZeroPageY,
+    OperandAbsolute,
+    OperandAbsoluteX,
+    OperandAbsoluteY,
+    OperandIndirect,
+    OperandIndirectX,
+    OperandIndirectY,
+    OperandRelative,
+};
+
+struct OpcodeInfo {
+    const char* mnemonic;
+    OperandFormat format;
+};
+
+const OpcodeInfo& opcodeInfo(uint8_t opcode);
+
+/*
+* Instruction size in bytes, including the opcode.
+*/
+int instructionLength(uint8_t opcode);
+
+/*
+* Formats one instruction in nestest style, e.g. "LDA ($20),Y" or "BNE $C72D".
+* pc is the address of the opcode, used to resolve branch targets.
+*/
+std::string disassemble(uint16_t pc, uint8_t opcode, uint8_t lo, uint8_t hi);
\ No newline at end of file
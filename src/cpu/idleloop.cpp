@@ -0,0 +1,70 @@
+#include "cpu.h"
+#include <string_view>
+
+#define JMPAbsolute 0x4C
+#define BPL 0x10
+#define BMI 0x30
+
+/*
+* Between two PPU events RAM only changes through the CPU itself (an NMI can only come in
+* after the branch), and PPUSTATUS bit 7 only through the vblank event. Reading PPUSTATUS
+* again within that window changes nothing.
+*/
+static bool idleLoad(const DecodedInstruction& load, uint8_t branch) {
+    const OpcodeInfo& info = opcodeInfo(load.opcode);
+    std::string_view mnemonic = info.mnemonic;
+    if ((mnemonic != "LDA" && mnemonic != "LDX" && mnemonic != "LDY" && mnemonic != "BIT") ||
+        (info.format != OperandZeroPage && info.format != OperandAbsolute)) {
+        return false;
+    }
+    if (load.operand < 0x2000) {
+        return true;
+    }
+    return load.operand < 0x4000 && (load.operand & 0x7) == (PPUSTATUS & 0x7) && (branch == BPL || branch == BMI);
+}
+
+bool cpu::idleLoop(uint16_t head, uint16_t jump) {
+    if (head < PRGCodeStart || jump < PRGCodeStart) {
+        return false;
+    }
+
+    const DecodedInstruction& last = decodedCode[jump - PRGCodeStart];
+    if (head == jump) {
+        return last.opcode == JMPAbsolute && last.operand == head;
+    }
+
+    const DecodedInstruction& load = decodedCode[head - PRGCodeStart];
+    return load.length && head + load.length == jump &&
+        opcodeInfo(last.opcode).format == OperandRelative &&
+        static_cast<uint16_t>(jump + 2 + static_cast<int8_t>(last.operand)) == head &&
+        idleLoad(load, last.opcode);
+}
+
+void cpu::skipIdleLoop(uint16_t jump) {
+    if (!idleLoop(program_counter, jump)) {
+        return;
+    }
+
+    /*
+    * The vblank event may have run between the PPUSTATUS read and the branch, the next
+    * read has to see it.
+    */
+    if (jump != program_counter && decodedCode[program_counter - PRGCodeStart].operand >= 0x2000 &&
+        Bus->getPPUVBlankFlag()) {
+        return;
+    }
+
+    /*
+    * skipCycles holds the cycles of the jump including branch penalties, which stay the same
+    * for every iteration. Iterations are skipped only while they end before the PPU could catch
+    * up, so the loop still sees the event on the same cycle.
+    */
+    int iteration = skipCycles;
+    if (jump != program_counter) {
+        iteration += decodedCode[program_counter - PRGCodeStart].cycles;
+    }
+    int iterations = (Bus->getPPUEventFreeDots() / 3 - skipCycles) / iteration - 1;
+    if (iterations > 0) {
+        skipCycles += iterations * iteration;
+    }
+}
@@ -0,0 +1,203 @@
+#include "cpu.h"
+
+#if NEMU_JIT
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+* Prologue, per instruction call and epilogue sizes in bytes, see Recompiler::compile.
+*/
+#define JitPrologueSize 4
+#define JitCallSize 25
+#define JitEpilogueSize 7
+
+static void emit(uint8_t*& out, std::initializer_list<uint8_t> bytes) {
+    for (uint8_t byte : bytes) {
+        *out++ = byte;
+    }
+}
+
+template<typename T>
+static void emitImmediate(uint8_t*& out, T value) {
+    std::memcpy(out, &value, sizeof(value));
+    out += sizeof(value);
+}
+
+/*
+* Changes the protection of every page overlapping [begin, end).
+*/
+static bool protect(uint8_t* begin, uint8_t* end, int protection) {
+    uintptr_t pageSize = uintptr_t(sysconf(_SC_PAGESIZE));
+    uintptr_t first = reinterpret_cast<uintptr_t>(begin) & ~(pageSize - 1);
+    uintptr_t last = (reinterpret_cast<uintptr_t>(end) + pageSize - 1) & ~(pageSize - 1);
+    return mprotect(reinterpret_cast<void*>(first), last - first, protection) == 0;
+}
+
+Recompiler::Recompiler() : used(0) {
+    void* memory = mmap(nullptr, JitCodeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        std::cout << "[NEMU] Error: Cannot map JIT code buffer, running interpreted.\n";
+        memory = nullptr;
+    }
+    code = static_cast<uint8_t*>(memory);
+}
+
+Recompiler::~Recompiler() {
+    if (code) {
+        munmap(code, JitCodeSize);
+    }
+}
+
+Recompiler::Block Recompiler::compile(const Call* calls, std::size_t count, int cycles) {
+    std::size_t size = JitPrologueSize + count * JitCallSize + JitEpilogueSize;
+    if (!code || used + size > JitCodeSize) {
+        return nullptr;
+    }
+
+    uint8_t* start = code + used;
+    if (!protect(start, start + size, PROT_READ | PROT_WRITE)) {
+        std::cout << "[NEMU] Error: Cannot make JIT code writable, running interpreted.\n";
+        munmap(code, JitCodeSize);
+        code = nullptr;
+        return nullptr;
+    }
+
+    uint8_t* out = start;
+    emit(out, {0x53});                          // push rbx, also aligns the stack for the calls
+    emit(out, {0x48, 0x89, 0xfb});              // mov rbx, rdi
+    for (std::size_t i = 0; i < count; ++i) {
+        emit(out, {0x48, 0x89, 0xdf});          // mov rdi, rbx
+        emit(out, {0xbe});                      // mov esi, pc
+        emitImmediate<uint32_t>(out, calls[i].pc);
+        emit(out, {0xba});                      // mov edx, operand
+        emitImmediate<uint32_t>(out, calls[i].operand);
+        emit(out, {0x48, 0xb8});                // mov rax, step
+        emitImmediate<uint64_t>(out, reinterpret_cast<uintptr_t>(calls[i].step));
+        emit(out, {0xff, 0xd0});                // call rax
+    }
+    emit(out, {0xb8});                          // mov eax, cycles
+    emitImmediate<uint32_t>(out, cycles);
+    emit(out, {0x5b, 0xc3});                    // pop rbx, ret
+
+    if (!protect(start, out, PROT_READ | PROT_EXEC)) {
+        std::cout << "[NEMU] Error: Cannot make JIT code executable, running interpreted.\n";
+        munmap(code, JitCodeSize);
+        code = nullptr;
+        return nullptr;
+    }
+    used += out - start;
+    return reinterpret_cast<Block>(start);
+}
+
+/*
+* RAM and, for reads, directly mapped PRG-ROM have no side effects and never need the PPU
+* to catch up, so a block touching only them can run ahead of the cycle loop.
+*/
+bool cpu::plainMemory(uint32_t addr, bool write) {
+    if (addr < 0x2000) {
+        return true;
+    }
+    return !write && addr >= PRGCodeStart && addr <= 0xffff && Bus->getReadPage(addr >> 8);
+}
+
+bool cpu::compilable(const DecodedInstruction& instruction) {
+    std::string_view mnemonic = opcodeInfo(instruction.opcode).mnemonic;
+    bool write = mnemonic == "STA" || mnemonic == "STX" || mnemonic == "STY" ||
+        mnemonic == "ASL" || mnemonic == "ROL" || mnemonic == "LSR" || mnemonic == "ROR" ||
+        mnemonic == "INC" || mnemonic == "DEC";
+    uint16_t addr = instruction.operand;
+
+    switch (opcodeInfo(instruction.opcode).format) {
+        case OperandNone:
+        case OperandAccumulator:
+        case OperandImmediate:
+        case OperandRelative:
+        case OperandZeroPage:
+        case OperandZeroPageX:
+        case OperandZeroPageY:
+            return true;
+        case OperandAbsolute:
+            return mnemonic == "JSR" || mnemonic == "JMP" || plainMemory(addr, write);
+        case OperandAbsoluteX:
+        case OperandAbsoluteY:
+            return plainMemory(addr, write) && plainMemory(addr + 0xff, write);
+        case OperandIndirect:
+            return plainMemory(addr, false) && plainMemory((addr & 0xff00) | ((addr + 1) & 0xff), false);
+        default:
+            /*
+            * (zp,X) and (zp),Y only know their address at run time.
+            */
+            return false;
+    }
+}
+
+void cpu::compileBlock(uint16_t addr, CompiledBlock& block) {
+    block.heat = JitNotCompilable;
+
+    std::array<Recompiler::Call, 0x100> calls;
+    std::size_t count = 0;
+    int cycles = 0;
+    int maxCycles = 0;
+    for (uint16_t pc = addr; (pc & 0xff00) == (addr & 0xff00);) {
+        const DecodedInstruction& instruction = decodedCode[pc - PRGCodeStart];
+        if (!instruction.length || !compilable(instruction)) {
+            break;
+        }
+        pc += instruction.length;
+        calls[count++] = {compiledSteps[instruction.opcode], pc, instruction.operand};
+        cycles += instruction.cycles;
+        maxCycles += instruction.cycles + JitPenaltyCycles;
+        if (endsBlock(instruction.opcode)) {
+            /*
+            * Idle loops stay in the interpreter, which skips them.
+            */
+            if (idleLoop(addr, pc - instruction.length)) {
+                return;
+            }
+            break;
+        }
+    }
+    if (!count) {
+        return;
+    }
+
+    block.code = recompiler.compile(calls.data(), count, cycles);
+    if (!block.code) {
+        /*
+        * Code buffer full: start over, hot blocks are compiled again on their next run.
+        */
+        recompiler.clear();
+        std::fill(compiledCode.begin(), compiledCode.end(), CompiledBlock{});
+        return;
+    }
+    block.maxCycles = maxCycles;
+}
+
+bool cpu::runCompiledBlock(int budget) {
+    CompiledBlock& block = compiledCode[program_counter - PRGCodeStart];
+    if (!block.code) {
+        if (block.heat == JitNotCompilable || ++block.heat < JitHotThreshold) {
+            return false;
+        }
+        compileBlock(program_counter, block);
+        if (!block.code) {
+            return false;
+        }
+    }
+
+    /*
+    * Every instruction of the block runs now, so no NMI may become due before the last one
+    * and the caller may not stop before it.
+    */
+    if (block.maxCycles > budget || block.maxCycles * 3 > Bus->getPPUEventFreeDots()) {
+        return false;
+    }
+    skipCycles += block.code(this);
+    return true;
+}
+
+#endif
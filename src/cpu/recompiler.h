@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+class cpu;
+
+/*
+* x86-64 code buffer of the optional recompiler (NEMU_JIT). A compiled block is a call-threaded
+* copy of a decoded PRG-ROM block: it calls the handler of every instruction, with the program
+* counter and operand as immediates, and returns the summed base cycles. The calls are indirect
+* (mov rax, imm64; call rax) since the handlers may lie further than rel32 from the buffer.
+* Handlers still add page crossing and branch penalties themselves, so cycle accounting matches
+* the interpreter. The buffer is never writable and executable at the same time, compile makes
+* the pages it emits to writable and read/execute again before the block can run.
+*/
+#define JitCodeSize (4 << 20)
+
+class Recompiler {
+public:
+    using Block = int (*)(cpu*);
+    using Step = void (*)(cpu*, uint16_t pc, uint16_t operand);
+
+    struct Call {
+        Step step;
+        uint16_t pc;
+        uint16_t operand;
+    };
+
+    Recompiler();
+    ~Recompiler();
+    Recompiler(const Recompiler&) = delete;
+    Recompiler& operator=(const Recompiler&) = delete;
+
+    /*
+    * Emits calls[0..count) as one block, nullptr once the code buffer is full.
+    */
+    Block compile(const Call* calls, std::size_t count, int cycles);
+
+    /*
+    * Drops every compiled block.
+    */
+    void clear() {
+        used = 0;
+    }
+
+private:
+    uint8_t* code;
+    std::size_t used;
+};
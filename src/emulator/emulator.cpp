@@ -1,39 +1,42 @@
 #include "emulator.h"
 
-emulator::emulator(std::string path) : screenScale(3.f) {
-    pCartridge = std::make_shared<Cartridge>(path);
-    pMapper = Mapper::createMapper(static_cast<MapperType>(pCartridge->getMapper()), *pCartridge.get());
-    pScreen = std::make_shared<Screen>();
-    pPictureBus = std::make_shared<picturebus>(pMapper);
-    pPpu = std::make_shared<PPU>(pPictureBus, pScreen);
-    pBus = std::make_shared<bus>(pMapper, pPpu);
-    pCpu = std::make_shared<cpu>(pBus);
-
-    if(!pBus->setReadCallback(PPUSTATUS, [&]() -> uint8_t { return pPpu->getStatus(); }) ||
-        !pBus->setReadCallback(PPUDATA, [&]() -> uint8_t { return pPpu->getData(); }) ||
-        !pBus->setReadCallback(JOY1, [&]() -> uint8_t { return 0; }) ||
-        !pBus->setReadCallback(JOY2, [&]() -> uint8_t { return 0; }) ||
-        !pBus->setReadCallback(OAMDATA, [&]() -> uint8_t { return pPpu->getOAMData(); })) {
+static std::shared_ptr<Screen> createScreen(std::shared_ptr<Screen> screen, float scale) {
+    if (!screen) {
+        screen = std::make_shared<Screen>();
+    }
+    screen->create(NESVideoWidth, NESVideoHeight, scale, Color(255, 255, 255, 255));
+    return screen;
+}
+
+emulator::emulator(std::string path, std::shared_ptr<Screen> screen) :
+    screenScale(3.f),
+    pScreen(createScreen(screen, screenScale)),
+    system(Cartridge::load(path), *pScreen) {
+
+    /*
+    * PPU registers are dispatched statically by the bus, only the remaining I/O needs callbacks.
+    */
+    if(!system.mainBus.setReadCallback(JOY1, [&]() -> uint8_t { return 0; }) ||
+        !system.mainBus.setReadCallback(JOY2, [&]() -> uint8_t { return 0; })) {
         std::cout << "[NEMU] Error: Failed to set I/O callbacks.\n";
     } 
 
-    if(!pBus->setWriteCallback(PPUCTRL, [&](uint8_t b) { pPpu->control(b); }) ||
-        !pBus->setWriteCallback(PPUMASK, [&](uint8_t b) { pPpu->setMask(b); }) ||
-        !pBus->setWriteCallback(OAMADDR, [&](uint8_t b) { pPpu->setOAMAddress(b); }) ||
-        !pBus->setWriteCallback(PPUADDR, [&](uint8_t b) { pPpu->setDataAddress(b); }) ||
-        !pBus->setWriteCallback(PPUSCROL, [&](uint8_t b) { pPpu->setScroll(b); }) ||
-        !pBus->setWriteCallback(PPUDATA, [&](uint8_t b) { pPpu->setData(b); }) ||
-        !pBus->setWriteCallback(OAMDMA, [&](uint8_t b) { DMA(b); }) ||
-        !pBus->setWriteCallback(JOY1, [&](uint8_t b) {  }) ||
-        !pBus->setWriteCallback(OAMDATA, [&](uint8_t b) { pPpu->setOAMData(b); })) {
+    if(!system.mainBus.setWriteCallback(OAMDMA, [&](uint8_t b) { DMA(b); }) ||
+        !system.mainBus.setWriteCallback(JOY1, [&](uint8_t b) {  })) {
         std::cout << "[NEMU] Error: Failed to set I/O callbacks.\n";
     }
 
-    pPpu->setInterruptCallback([&](){ pCpu->interrupt(Interrupt::NMI); });
+    system.ppu.setInterruptCallback([&](){ system.processor.interrupt(Interrupt::NMI); });
     
-    pCpu->reset();
-    pPpu->reset();
-    pScreen->create(NESVideoWidth, NESVideoHeight, screenScale, Color(255, 255, 255, 255));
+    if (system.loaded) {
+        system.processor.reset();
+        system.ppu.reset();
+    }
+
+    StateWriter measure(nullptr, 0);
+    stateLength = 0;
+    writeState(measure);
+    stateLength = measure.length();
     cycleTimer = std::chrono::high_resolution_clock::now();
     elapsedTime = cycleTimer - cycleTimer;
 }
@@ -50,11 +53,119 @@ void emulator::setVideoScale(float scale) {
     screenScale = scale;
 }
 
+/*
+* The CPU runs ahead of the PPU, the PPU catches up when an event is due or when the bus
+* touches its registers, so both observe the same timing as stepping 3 dots per cycle.
+* The CPU may run further cycles itself, and cycles in which it only waits are then run in one
+* batch, up to limit cycles in total and never past the next PPU event. When this cycle ends a
+* frame the caller may stop, so only this cycle runs. Returns the cycles run.
+*/
+inline uint64_t emulator::step(uint64_t limit) {
+    uint64_t frame = system.ppu.getFrameCount();
+    if (system.ppu.defer(3)) {
+        system.ppu.catchUp();
+    }
+    if (system.ppu.getFrameCount() != frame) {
+        system.processor.step();
+        return 1;
+    }
+    uint64_t ran = system.processor.step(int(std::min<uint64_t>(limit, INT_MAX)));
+
+    uint64_t idle = std::min<uint64_t>({uint64_t(system.processor.idleCycles()), uint64_t(system.ppu.eventFreeDotsLeft() / 3), limit - ran});
+    if (idle) {
+        system.ppu.defer(3 * idle);
+        system.processor.skipIdleCycles(idle);
+    }
+    return ran + idle;
+}
+
+bool emulator::runFrame() {
+    if (!system.loaded) {
+        return false;
+    }
+    uint64_t frame = system.ppu.getFrameCount();
+    while (system.ppu.getFrameCount() == frame) {
+        step(UINT64_MAX);
+    }
+    system.ppu.catchUp();
+    return true;
+}
+
+void emulator::runCycles(uint64_t cycles) {
+    if (!system.loaded) {
+        return;
+    }
+    for (uint64_t i = 0; i < cycles;) {
+        i += step(cycles - i);
+    }
+    system.ppu.catchUp();
+}
+
+void emulator::enableTrace(std::size_t records) {
+    pTrace = std::make_shared<TraceBuffer>(records);
+    system.processor.setTraceBuffer(pTrace);
+}
+
+bool emulator::saveTrace(const std::string& path) {
+    if (!pTrace) {
+        std::cout << "[NEMU] Error: Tracing is not enabled.\n";
+        return false;
+    }
+    return pTrace->save(path);
+}
+
+void emulator::writeState(StateWriter& state) const {
+    state.write(StateMagic, StateMagicLength);
+    state.write(uint16_t(StateVersion));
+    state.write(uint8_t(system.pMapper->getType()));
+    state.write(stateLength);
+    system.saveState(state);
+}
+
+std::size_t emulator::saveState(uint8_t* buffer, std::size_t size) const {
+    if (size < stateLength) {
+        std::cout << "[NEMU] Error: Save state buffer is too small.\n";
+        return 0;
+    }
+    StateWriter state(buffer, size);
+    writeState(state);
+    return state.length();
+}
+
+bool emulator::loadState(const uint8_t* buffer, std::size_t size) {
+    StateReader state(buffer, size);
+    char magic[StateMagicLength];
+    uint16_t version;
+    uint8_t mapperType;
+    uint32_t length;
+    state.read(magic, StateMagicLength);
+    state.read(version);
+    state.read(mapperType);
+    state.read(length);
+
+    if (state.failed() || std::memcmp(magic, StateMagic, StateMagicLength) != 0) {
+        std::cout << "[NEMU] Error: Buffer does not hold a save state.\n";
+        return false;
+    }
+    if (version != StateVersion) {
+        std::cout << "[NEMU] Error: Unsupported save state version " << version << ".\n";
+        return false;
+    }
+    if (mapperType != system.pMapper->getType() || length != stateLength || size < length) {
+        std::cout << "[NEMU] Error: Save state does not match the loaded cartridge.\n";
+        return false;
+    }
+
+    system.loadState(state);
+    return true;
+}
+
 bool emulator::loop() {
-    pPpu->step();
-    pPpu->step();
-    pPpu->step();
-    pCpu->step();
+    if (!system.loaded) {
+        return false;
+    }
+    step(1);
+    system.ppu.catchUp();
     pScreen->setPixel(9, 9, Color(24, 47, 31, 255));
 
     //pScreen->draw();
@@ -67,10 +178,11 @@ bool emulator::loop() {
 }
 
 void emulator::DMA(uint8_t page) {
-    pCpu->skipDMACycles();
-    auto page_ptr = pBus->getPagePtr(page);
+    system.ppu.catchUp();
+    system.processor.skipDMACycles();
+    auto page_ptr = system.mainBus.getPagePtr(page);
     if (page_ptr != nullptr) {
-        pPpu->doDMA(page_ptr);
+        system.ppu.doDMA(page_ptr);
     } else {
         std::cout << "[NEMU] Error: Cannot get pageptr for DMA.\n";
     }
@@ -3,14 +3,10 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <algorithm>
+#include <climits>
 #include <memory>
-#include "../ppu/ppu.h"
-#include "../cpu/cpu.h"
-#include "../cartridge/cartridge.h"
-#include "../mapper/mapper.h"
-#include "../bus/bus.h"
-#include "../ppu/ppu.h"
-#include "../picturebus/picturebus.h"
+#include "system.h"
 #include "../Screen/Screen.h"
 
 using TimePoint = std::chrono::high_resolution_clock::time_point;
@@ -20,23 +16,58 @@ const int NESVideoHeight = VisibleScanlines;
 
 class emulator {
 public:
-    emulator(std::string path);
+    /*
+    * screen is where frames are presented, a headless Screen is used when it is null.
+    */
+    emulator(std::string path, std::shared_ptr<Screen> screen = nullptr);
     void setVideoWidth(int width);
     void setVideoHeight(int height);
     void setVideoScale(float scale);
     bool loop();
+
+    /*
+    * False when the cartridge could not be loaded, nothing runs then.
+    */
+    bool loaded() const {
+        return system.loaded;
+    }
+
+    /*
+    * Batch execution: both keep CPU/PPU interleaving inside one loop.
+    * runFrame returns once the PPU has finished a frame, runCycles after the given number of CPU cycles.
+    * runFrame returns false when nothing can run.
+    */
+    bool runFrame();
+    void runCycles(uint64_t cycles);
+
+    /*
+    * Keeps the last records CPU instructions in memory, saveTrace writes them out for nemu_trace.
+    */
+    void enableTrace(std::size_t records);
+    bool saveTrace(const std::string& path);
+
+    /*
+    * Save states in the format described in state.h, written to and read from caller memory
+    * without allocating. saveState returns the state length, or 0 when size is below stateSize().
+    * loadState only accepts a state saved with the same cartridge and leaves the machine
+    * untouched when buffer does not hold one.
+    */
+    std::size_t stateSize() const {
+        return stateLength;
+    }
+    std::size_t saveState(uint8_t* buffer, std::size_t size) const;
+    bool loadState(const uint8_t* buffer, std::size_t size);
 private:
+    uint64_t step(uint64_t limit);
+    void writeState(StateWriter& state) const;
     void DMA(uint8_t page);
 
     float screenScale;
     TimePoint cycleTimer;
     std::chrono::high_resolution_clock::duration elapsedTime;
     std::chrono::nanoseconds cpuCycleDuration;
-    std::shared_ptr<Cartridge> pCartridge;
-    std::shared_ptr<Mapper> pMapper;
     std::shared_ptr<Screen> pScreen;
-    std::shared_ptr<picturebus> pPictureBus;
-    std::shared_ptr<PPU> pPpu;
-    std::shared_ptr<bus> pBus;
-    std::shared_ptr<cpu> pCpu;
+    System system;
+    std::shared_ptr<TraceBuffer> pTrace;
+    uint32_t stateLength;
 };
\ No newline at end of file
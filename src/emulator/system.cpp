@@ -0,0 +1,43 @@
+#include "system.h"
+#include "../Mapper/nrom/nrom.h"
+
+/*
+* Falls back to NROM so the components always have a mapper to refer to, see System::loaded.
+*/
+static std::shared_ptr<Mapper> createMapper(std::shared_ptr<const Cartridge> cart, bool& loaded) {
+    std::shared_ptr<Mapper> mapper = Mapper::createMapper(static_cast<MapperType>(cart->getMapper()), cart);
+    loaded = mapper && !cart->getROM().empty();
+    if (!loaded) {
+        std::cout << "[NEMU] Error: Cannot run this cartridge.\n";
+    }
+    if (!mapper) {
+        mapper = std::make_shared<MapperNROM>(cart);
+    }
+    return mapper;
+}
+
+System::System(std::shared_ptr<const Cartridge> cart, Screen& screen) :
+    pCartridge(cart),
+    loaded(false),
+    pMapper(createMapper(cart, loaded)),
+    pictureBus(*pMapper),
+    ppu(pictureBus, screen),
+    mainBus(*pMapper, ppu),
+    processor(mainBus) {
+}
+
+void System::saveState(StateWriter& state) const {
+    processor.saveState(state);
+    mainBus.saveState(state);
+    ppu.saveState(state);
+    pictureBus.saveState(state);
+    pMapper->saveState(state);
+}
+
+void System::loadState(StateReader& state) {
+    processor.loadState(state);
+    mainBus.loadState(state);
+    ppu.loadState(state);
+    pictureBus.loadState(state);
+    pMapper->loadState(state);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <memory>
+#include "../Cartridge/Cartridge.h"
+#include "../Mapper/Mapper.h"
+#include "../picturebus/picturebus.h"
+#include "../ppu/ppu.h"
+#include "../bus/bus.h"
+#include "../cpu/cpu.h"
+#include "../Screen/Screen.h"
+#include "../state/state.h"
+
+/*
+* The whole machine in one object. The components are embedded by value in dependency order
+* and refer to each other through plain pointers, so the CPU, bus and PPU state sits next to
+* each other and a bus access does not go through shared_ptr control blocks.
+* Only the cartridge and the mapper, which is polymorphic, live outside. Each component keeps
+* its per-cycle state first, caches (decoded and compiled code, sprite lists) and callbacks
+* after it. The System is no plain block of memory and cannot be copied with memcpy: it holds
+* pointers into itself, vectors and std::function, so snapshots go through saveState.
+* For the same reason it cannot be copied or moved.
+*/
+class System {
+public:
+    /*
+    * screen must have been created, the PPU renders into its back buffer.
+    */
+    System(std::shared_ptr<const Cartridge> cart, Screen& screen);
+    System(const System&) = delete;
+    System& operator=(const System&) = delete;
+
+    /*
+    * The save state sections of every component, in the order of the format in state.h.
+    */
+    void saveState(StateWriter& state) const;
+    void loadState(StateReader& state);
+
+    std::shared_ptr<const Cartridge> pCartridge;
+
+    /*
+    * False when the cartridge cannot run: it has no PRG-ROM or its mapper is not supported.
+    * The components are then built on a placeholder NROM mapper and must not be stepped.
+    */
+    bool loaded;
+    std::shared_ptr<Mapper> pMapper;
+    picturebus pictureBus;
+    PPU ppu;
+    bus mainBus;
+    cpu processor;
+};
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "emulator/emulator.h"
+
+#define DefaultTraceRecords (1 << 16)
+
+/*
+* Runs a ROM without a window for a fixed number of frames and reports the speed.
+* With --trace the last instructions are written to a binary trace for nemu_trace.
+* With --cycles every run is that many CPU cycles instead of a frame, and --states appends
+* a save state after every run, so two builds can be compared state by state.
+*/
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::string tracePath;
+    std::string statesPath;
+    uint64_t frames = 600;
+    uint64_t cycles = 0;
+    std::size_t traceRecords = DefaultTraceRecords;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--trace-records" && i + 1 < argc) {
+            traceRecords = std::stoull(argv[++i]);
+        } else if (arg == "--states" && i + 1 < argc) {
+            statesPath = argv[++i];
+        } else if (arg == "--cycles" && i + 1 < argc) {
+            cycles = std::stoull(argv[++i]);
+        } else if (path.empty()) {
+            path = arg;
+        } else {
+            frames = std::stoull(arg);
+        }
+    }
+
+    if (path.empty()) {
+        std::cout << "Usage: nemu_headless <rom> [frames] [--trace <file>] [--trace-records <count>] [--states <file>] [--cycles <count>]\n";
+        return 1;
+    }
+
+    emulator emu(path);
+    if (!emu.loaded()) {
+        return 1;
+    }
+    if (!tracePath.empty()) {
+        emu.enableTrace(traceRecords);
+    }
+
+    std::ofstream states;
+    std::vector<uint8_t> state(emu.stateSize());
+    if (!statesPath.empty()) {
+        states.open(statesPath, std::ios::binary);
+        if (!states) {
+            std::cout << "[NEMU] Error: Cannot open " << statesPath << ".\n";
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < frames; ++i) {
+        if (cycles) {
+            emu.runCycles(cycles);
+        } else {
+            emu.runFrame();
+        }
+        if (states.is_open()) {
+            emu.saveState(state.data(), state.size());
+            states.write(reinterpret_cast<const char*>(state.data()), state.size());
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    const char* unit = cycles ? " runs" : " frames";
+    std::cout << std::dec << "[NEMU] INFO: " << frames << unit << " in " << elapsed.count() << "s (" << frames / elapsed.count() << unit << "/s)\n";
+
+    if (!tracePath.empty() && !emu.saveTrace(tracePath)) {
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
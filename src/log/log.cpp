@@ -0,0 +1,110 @@
+#include "log.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+
+#define LogFlushInterval std::chrono::milliseconds(1)
+
+static const char* levelNames[] = {"", "Error", "WARNING", "INFO", "TRACE"};
+
+Log::Log() : ring(LogRingSize), writePosition(0), readPosition(0), dropped(0), running(true) {
+    for (std::size_t i = 0; i < ring.size(); ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    flusher = std::thread([this]() { flushLoop(); });
+}
+
+Log::~Log() {
+    running = false;
+    flusher.join();
+    drain();
+}
+
+Log& Log::instance() {
+    static Log log;
+    return log;
+}
+
+void Log::write(int level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    Log& log = instance();
+    if (!log.push(level, format, args)) {
+        log.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    va_end(args);
+}
+
+void Log::flush() {
+    Log& log = instance();
+    while (log.readPosition.load(std::memory_order_acquire) != log.writePosition.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(LogFlushInterval);
+    }
+}
+
+/*
+* Bounded multi-producer queue: a slot is free for the producer when its sequence equals
+* the write position, and readable for the flusher once the producer published position + 1.
+*/
+bool Log::push(int level, const char* format, va_list args) {
+    std::size_t position = writePosition.load(std::memory_order_relaxed);
+    Record* record;
+    for (;;) {
+        record = &ring[position % ring.size()];
+        std::size_t sequence = record->sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (sequence < position) {
+            return false; // full
+        } else {
+            position = writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    int length = std::snprintf(record->text, LogRecordSize, "[NEMU] %s: ", levelNames[level]);
+    std::vsnprintf(record->text + length, LogRecordSize - length, format, args);
+    record->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool Log::pop(char* text) {
+    std::size_t position = readPosition.load(std::memory_order_relaxed);
+    Record& record = ring[position % ring.size()];
+    if (record.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    std::memcpy(text, record.text, LogRecordSize);
+    record.sequence.store(position + ring.size(), std::memory_order_release);
+    readPosition.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+std::size_t Log::drain() {
+    char text[LogRecordSize];
+    std::size_t count = 0;
+    while (pop(text)) {
+        std::cout << text << '\n';
+        ++count;
+    }
+
+    if (std::size_t lost = dropped.exchange(0, std::memory_order_relaxed)) {
+        std::cout << std::dec << "[NEMU] WARNING: " << lost << " log records dropped.\n";
+    }
+
+    if (count) {
+        std::cout.flush();
+    }
+    return count;
+}
+
+void Log::flushLoop() {
+    while (running) {
+        if (!drain()) {
+            std::this_thread::sleep_for(LogFlushInterval);
+        }
+    }
+}
\ No newline at end of file
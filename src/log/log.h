@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/*
+* Levels and categories are fixed at compile time through NEMU_LOG_LEVEL and NEMU_LOG_CATEGORIES,
+* a disabled log call compiles to nothing.
+*/
+#define LogLevelNone 0
+#define LogLevelError 1
+#define LogLevelWarning 2
+#define LogLevelInfo 3
+#define LogLevelTrace 4
+
+#define LogCPU 0x01
+#define LogPPU 0x02
+#define LogBus 0x04
+#define LogMapper 0x08
+#define LogEmulator 0x10
+#define LogAll 0xff
+
+#ifndef NEMU_LOG_LEVEL
+#define NEMU_LOG_LEVEL LogLevelInfo
+#endif
+
+#ifndef NEMU_LOG_CATEGORIES
+#define NEMU_LOG_CATEGORIES LogAll
+#endif
+
+constexpr bool logEnabled(int level, int category) {
+    return level <= NEMU_LOG_LEVEL && (category & NEMU_LOG_CATEGORIES);
+}
+
+#define NEMU_LOG(level, category, ...) \
+    do { \
+        if constexpr (logEnabled(level, category)) { \
+            Log::write(level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define NEMU_ERROR(category, ...) NEMU_LOG(LogLevelError, category, __VA_ARGS__)
+#define NEMU_WARNING(category, ...) NEMU_LOG(LogLevelWarning, category, __VA_ARGS__)
+#define NEMU_INFO(category, ...) NEMU_LOG(LogLevelInfo, category, __VA_ARGS__)
+#define NEMU_TRACE(category, ...) NEMU_LOG(LogLevelTrace, category, __VA_ARGS__)
+
+#define LogRecordSize 128
+#define LogRingSize 0x10000
+
+/*
+* Log records go through a bounded lock-free ring buffer, any thread may write and
+* a background thread flushes them to std::cout. A full ring drops records instead of
+* blocking the emulator, the number of dropped records is reported on the next flush.
+*/
+class Log {
+public:
+    static void write(int level, const char* format, ...);
+
+    /*
+    * Blocks until every record written so far has been printed.
+    */
+    static void flush();
+private:
+    struct Record {
+        std::atomic<std::size_t> sequence;
+        char text[LogRecordSize];
+    };
+
+    Log();
+    ~Log();
+    static Log& instance();
+
+    bool push(int level, const char* format, va_list args);
+    bool pop(char* text);
+    void flushLoop();
+    std::size_t drain();
+
+    std::vector<Record> ring;
+    std::atomic<std::size_t> writePosition;
+    std::atomic<std::size_t> readPosition;
+    std::atomic<std::size_t> dropped;
+    std::atomic<bool> running;
+    std::thread flusher;
+};
@@ -1,14 +1,27 @@
 #include <iostream>
 #include <memory>
+#include <string>
 #include "emulator/emulator.h"
+#include "Screen/GLFWScreen.h"
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    std::string path = "../01-basics.nes";
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        } else {
+            path = arg;
+        }
+    }
+
+    if (argc < 2) {
         std::cout << "Please provide rom args.\n";
     }
-    emulator emu("../01-basics.nes");//argv[1]);
-    while (emu.loop()) {
+    emulator emu(path, headless ? std::make_shared<Screen>() : std::make_shared<GLFWScreen>());
+    while (emu.runFrame()) {
         
     }
-    return 0;
+    return emu.loaded() ? 0 : 1;
 }
\ No newline at end of file
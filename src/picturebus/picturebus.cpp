@@ -1,17 +1,19 @@
 #include "picturebus.h"
 
-picturebus::picturebus(std::shared_ptr<Mapper> map) : palette(0x20), vram(0x800), mapper(map) {
-    if (!mapper) {
-        std::cout << "[NEMU] Error: Mapper argument is nullptr.\n";
-    }
-    mapper = map;
+picturebus::picturebus(Mapper& map) : palette{}, vram{}, mapper(&map) {
     updateMirroring();
+    mapCHR();
+    mapper->setCHRBankSwitchCallback([this]() { mapCHR(); });
 }
 
-uint8_t picturebus::read(uint16_t addr) {
-    if (addr < 0x2000) {
-        return mapper->readCHR(addr);
-    } else if (addr <= 0x3eff) {
+void picturebus::mapCHR() {
+    for (std::size_t bank = 0; bank < chrPages.size(); ++bank) {
+        chrPages[bank] = mapper->getCHRPage(bank << 10);
+    }
+}
+
+uint8_t picturebus::readVRAM(uint16_t addr) {
+    if (addr <= 0x3eff) {
         const auto index = addr & 0x3ff;
         auto normalizedAddr = addr;
         if (addr >= 0x3000) {
@@ -103,4 +105,14 @@ void picturebus::updateMirroring() {
 
 void picturebus::scanlineIRQ(){
     mapper->scanlineIRQ();
+}
+
+void picturebus::saveState(StateWriter& state) const {
+    state.write(vram);
+    state.write(palette);
+}
+
+void picturebus::loadState(StateReader& state) {
+    state.read(vram);
+    state.read(palette);
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 #include <cstdint>
 #include <vector>
-#include "../mapper/mapper.h"
+#include <array>
+#include "../Mapper/Mapper.h"
 
 /*
 * Modified version of https://github.com/amhndu/SimpleNES/blob/9fec80c9dd30f6dfc61c9e130f718fee0ec6b20a/include/PaletteColors.h
@@ -20,19 +21,46 @@ const uint32_t colors[] = {
 
 class picturebus {
 public:
-    picturebus(std::shared_ptr<Mapper> map);
-    uint8_t read(uint16_t addr);
+    picturebus(Mapper& map);
+
+    /*
+    * Pattern table reads go straight through the CHR page table, so the PPU's
+    * tile and sprite fetches do not call into the mapper.
+    */
+    uint8_t read(uint16_t addr) {
+        if (addr < 0x2000) {
+            if (const uint8_t* page = chrPages[addr >> 10]) {
+                return page[addr & 0x3ff];
+            }
+            return mapper->readCHR(addr);
+        }
+        return readVRAM(addr);
+    }
     void write(uint16_t addr, uint8_t val);
 
     uint8_t readPalette(uint8_t paletteAddr);
     void updateMirroring();
     void scanlineIRQ();
+
+    /*
+    * Save state section: VRAM and palette, the name table layout follows the mapper.
+    */
+    void saveState(StateWriter& state) const;
+    void loadState(StateReader& state);
 private:
+    uint8_t readVRAM(uint16_t addr);
+    void mapCHR();
+
+    /*
+    * One entry per 1KB CHR bank, nullptr falls back to Mapper::readCHR.
+    */
+    std::array<const uint8_t*, 8> chrPages;
+
     size_t NameTable0;
     size_t NameTable1;
     size_t NameTable2;
     size_t NameTable3;
-    std::vector<uint8_t> palette;
-    std::vector<uint8_t> vram;
-    std::shared_ptr<Mapper> mapper;
+    std::array<uint8_t, 0x20> palette;
+    std::array<uint8_t, 0x800> vram;
+    Mapper* mapper;
 };
\ No newline at end of file
@@ -1,22 +1,27 @@
 #include "ppu.h"
 
-PPU::PPU(std::shared_ptr<picturebus> pictbus, std::shared_ptr<Screen> scr) : spriteMemory(64 * 4), pictureBuffer(ScanlineVisibleDots, std::vector<Color>(VisibleScanlines, Color(255, 0, 255, 0))), bus(pictbus), screen(scr) {
-    
+PPU::PPU(picturebus& pictbus, Screen& scr) : bus(&pictbus), screen(&scr), spriteMemory{} {
+    pictureBuffer = screen->getBackBuffer();
 }
 
 void PPU::reset() {
     longSprites = false;
     generateInterrupt = false;
     greyscaleMode = false;
+    hideEdgeSprites = false;
+    hideEdgeBackground = false;
     vblank = false;
+    sprZeroHit = false;
     spriteOverflow = false;
     showBackground = true;
     showSprites = true;
     evenFrame = true;
+    frameCount = 0;
     firstWrite = true;
     bgPage = Low;
     sprPage = Low;
     dataAddress = 0;
+    dataBuffer = 0;
     cycle = 0;
     scanline = 0;
     spriteDataAddress = 0;
@@ -26,6 +31,151 @@ void PPU::reset() {
     pipelineState = PreRender;
     scanlineSprites.reserve(8);
     scanlineSprites.resize(0);
+    pendingDots = 0;
+    eventFreeDots = dotsUntilEvent();
+    bgShiftLow = bgShiftHigh = 0;
+    attrShiftLow = attrShiftHigh = 0;
+}
+
+void PPU::saveState(StateWriter& state) const {
+    state.write(pipelineState);
+    state.write(cycle);
+    state.write(scanline);
+    state.write(evenFrame);
+    state.write(frameCount);
+    state.write(pendingDots);
+    state.write(eventFreeDots);
+    state.write(vblank);
+    state.write(sprZeroHit);
+    state.write(spriteOverflow);
+
+    state.write(dataAddress);
+    state.write(tempAddress);
+    state.write(fineXScroll);
+    state.write(firstWrite);
+    state.write(dataBuffer);
+    state.write(spriteDataAddress);
+
+    state.write(longSprites);
+    state.write(generateInterrupt);
+    state.write(greyscaleMode);
+    state.write(showSprites);
+    state.write(showBackground);
+    state.write(hideEdgeSprites);
+    state.write(hideEdgeBackground);
+    state.write(bgPage);
+    state.write(sprPage);
+    state.write(dataAddrIncrement);
+
+    state.write(bgShiftLow);
+    state.write(bgShiftHigh);
+    state.write(attrShiftLow);
+    state.write(attrShiftHigh);
+
+    state.write(spriteMemory);
+    uint8_t sprites[8] = {};
+    uint8_t spriteCount = scanlineSprites.size();
+    std::copy(scanlineSprites.begin(), scanlineSprites.end(), sprites);
+    state.write(spriteCount);
+    state.write(sprites);
+}
+
+void PPU::loadState(StateReader& state) {
+    state.read(pipelineState);
+    state.read(cycle);
+    state.read(scanline);
+    state.read(evenFrame);
+    state.read(frameCount);
+    state.read(pendingDots);
+    state.read(eventFreeDots);
+    state.read(vblank);
+    state.read(sprZeroHit);
+    state.read(spriteOverflow);
+
+    state.read(dataAddress);
+    state.read(tempAddress);
+    state.read(fineXScroll);
+    state.read(firstWrite);
+    state.read(dataBuffer);
+    state.read(spriteDataAddress);
+
+    state.read(longSprites);
+    state.read(generateInterrupt);
+    state.read(greyscaleMode);
+    state.read(showSprites);
+    state.read(showBackground);
+    state.read(hideEdgeSprites);
+    state.read(hideEdgeBackground);
+    state.read(bgPage);
+    state.read(sprPage);
+    state.read(dataAddrIncrement);
+
+    state.read(bgShiftLow);
+    state.read(bgShiftHigh);
+    state.read(attrShiftLow);
+    state.read(attrShiftHigh);
+
+    state.read(spriteMemory);
+    uint8_t sprites[8] = {};
+    uint8_t spriteCount = 0;
+    state.read(spriteCount);
+    state.read(sprites);
+    scanlineSprites.assign(sprites, sprites + std::min<uint8_t>(spriteCount, 8)); // within the capacity reserved by reset
+}
+
+void PPU::catchUp() {
+    for (; pendingDots > 0; --pendingDots) {
+        step();
+    }
+    eventFreeDots = dotsUntilEvent();
+}
+
+/*
+* Lines run dots 1 to ScanlineEndCycle, the pre-render line one dot less on odd frames with
+* rendering enabled. Deferred dots cannot cross the frame end, so they reach at most one
+* pre-render line, whose frame parity is flipped when the PPU enters it from vblank.
+*/
+uint32_t PPU::getFrameDot() const {
+    int line = pipelineState == PreRender ? FrameEndScanline : scanline;
+    int dot = cycle + pendingDots;
+    bool oddFrame = pipelineState == PreRender ? !evenFrame : evenFrame;
+
+    if (line != FrameEndScanline && dot > (FrameEndScanline - line) * ScanlineEndCycle) {
+        dot -= (FrameEndScanline - line) * ScanlineEndCycle;
+        line = FrameEndScanline;
+    }
+    int preRenderEnd = ScanlineEndCycle - (oddFrame && showBackground && showSprites);
+    if (line == FrameEndScanline && dot > preRenderEnd) {
+        dot -= preRenderEnd;
+        line = 0;
+    }
+    if (dot > ScanlineEndCycle) {
+        line += (dot - 1) / ScanlineEndCycle;
+        dot = (dot - 1) % ScanlineEndCycle + 1;
+    }
+    return line * ScanlineCycleLength + dot;
+}
+
+/*
+* Lower bound on how many dots can run before the frame end or the vblank NMI dot.
+* Every render scanline takes ScanlineEndCycle dots once it has started.
+*/
+int PPU::dotsUntilEvent() {
+    switch (pipelineState) {
+    case PreRender:
+        return VisibleScanlines * ScanlineEndCycle;
+    case Render:
+        return (VisibleScanlines - 1 - scanline) * ScanlineEndCycle;
+    case PostRender:
+        return ScanlineEndCycle - cycle;
+    case VerticalBlank:
+        if (scanline == VisibleScanlines + 1 && cycle <= 1) {
+            return 0;
+        }
+        return VisibleScanlines * ScanlineEndCycle;
+    default:
+        return 0;
+    }
 }
 
 void PPU::setInterruptCallback(std::function<void(void)> cb) {
@@ -68,30 +218,41 @@ void PPU::step() {
 
             if (showBackground) {
                 auto x_fine = (fineXScroll + x) % 8;
-                if (!hideEdgeBackground || x >= 8) {
-                    auto addr = 0x2000 | (dataAddress & 0x0FFF);
-                    uint8_t tile = read(addr);
 
-                    addr = (tile * 16) + ((dataAddress >> 12) & 0x7);
-                    addr |= bgPage << 12;
-                    bgColor = (read(addr) >> (7 ^ x_fine)) & 1;
-                    bgColor |= ((read(addr + 8) >> (7 ^ x_fine)) & 1) << 1;
+                /*
+                * Fetch once per tile: the first two tiles at the start of the line,
+                * then the tile after the current one every 8 pixels.
+                */
+                if (x == 0) {
+                    bgShiftLow = bgShiftHigh = attrShiftLow = attrShiftHigh = 0;
+                    fetchBackgroundTile(dataAddress);
+                    bgShiftLow <<= 8;
+                    bgShiftHigh <<= 8;
+                    attrShiftLow <<= 8;
+                    attrShiftHigh <<= 8;
+                    fetchBackgroundTile(nextTileAddress(dataAddress));
+                } else if (x % 8 == 0) {
+                    fetchBackgroundTile(nextTileAddress(dataAddress));
+                }
+
+                if (!hideEdgeBackground || x >= 8) {
+                    int bit = 15 - fineXScroll;
+                    bgColor = (bgShiftLow >> bit) & 1;
+                    bgColor |= ((bgShiftHigh >> bit) & 1) << 1;
 
                     bgOpaque = bgColor;
-                    
-                    addr = 0x23C0 | (dataAddress & 0x0C00) | ((dataAddress >> 4) & 0x38) | ((dataAddress >> 2) & 0x07);
-                    auto attribute = read(addr);
-                    int shift = ((dataAddress >> 4) & 4) | (dataAddress & 2);
-                    bgColor |= ((attribute >> shift) & 0x3) << 2;
+
+                    bgColor |= ((attrShiftLow >> bit) & 1) << 2;
+                    bgColor |= ((attrShiftHigh >> bit) & 1) << 3;
                 }
+
+                bgShiftLow <<= 1;
+                bgShiftHigh <<= 1;
+                attrShiftLow <<= 1;
+                attrShiftHigh <<= 1;
                 
                 if (x_fine == 7) {
-                    if ((dataAddress & 0x001F) == 31) {
-                        dataAddress &= ~0x001F;
-                        dataAddress ^= 0x0400;
-                    } else {
-                        dataAddress += 1;
-                    }
+                    dataAddress = nextTileAddress(dataAddress);
                 }
             }
 
@@ -158,7 +319,7 @@ void PPU::step() {
                 paletteAddr = 0;
             }
 
-            pictureBuffer[x][y] = Color(colors[bus->readPalette(paletteAddr)]);
+            pictureBuffer[y * ScanlineVisibleDots + x] = colors[bus->readPalette(paletteAddr) & 0x3f];
         } else if (cycle == ScanlineVisibleDots + 1 && showBackground) {
             /*
             * From NESDEV Wiki
@@ -223,13 +384,11 @@ void PPU::step() {
             cycle = 0;
             pipelineState = VerticalBlank;
 
-            for (std::size_t x = 0; x < pictureBuffer.size(); ++x) {
-                for (std::size_t y = 0; y < pictureBuffer[0].size(); ++y) {
-                    screen->setPixel(x, y, pictureBuffer[x][y]);
-                }
-            }
+            screen->swapBuffers();
+            pictureBuffer = screen->getBackBuffer();
 
             screen->draw();
+            ++frameCount;
 
         }
 
@@ -258,6 +417,37 @@ void PPU::step() {
     ++cycle;
 }
 
+/*
+* Loads the pattern and attribute bits of the tile at addr into the low byte of the shift registers.
+*/
+void PPU::fetchBackgroundTile(uint16_t addr) {
+    uint8_t tile = read(0x2000 | (addr & 0x0FFF));
+
+    uint16_t patternAddr = (tile * 16) + ((addr >> 12) & 0x7);
+    patternAddr |= bgPage << 12;
+    bgShiftLow |= read(patternAddr);
+    bgShiftHigh |= read(patternAddr + 8);
+
+    auto attribute = read(0x23C0 | (addr & 0x0C00) | ((addr >> 4) & 0x38) | ((addr >> 2) & 0x07));
+    int shift = ((addr >> 4) & 4) | (addr & 2);
+    uint8_t palette = (attribute >> shift) & 0x3;
+    attrShiftLow |= (palette & 1) ? 0xff : 0;
+    attrShiftHigh |= (palette & 2) ? 0xff : 0;
+}
+
+/*
+* Coarse X increment, from NESDEV Wiki
+*/
+uint16_t PPU::nextTileAddress(uint16_t addr) {
+    if ((addr & 0x001F) == 31) {
+        addr &= ~0x001F;
+        addr ^= 0x0400;
+    } else {
+        addr += 1;
+    }
+    return addr;
+}
+
 uint8_t PPU::readOAM(uint8_t addr) {
     return spriteMemory[addr];
 }
@@ -1,10 +1,14 @@
 #pragma once
 #include <functional>
+#include <cstring>
 #include <vector>
+#include <array>
+#include <algorithm>
 #include <memory>
 #include "../picturebus/picturebus.h"
 #include "../color/color.h"
 #include "../Screen/Screen.h"
+#include "../state/state.h"
 
 #define ScanlineCycleLength 341
 #define ScanlineEndCycle 340
@@ -28,14 +32,39 @@ enum CharacterPage {
 
 class PPU {
 public:
-    PPU(std::shared_ptr<picturebus> pictbus, std::shared_ptr<Screen> scr);
+    PPU(picturebus& pictbus, Screen& scr);
     void step();
     void reset();
+
+    /*
+    * Catch-up scheduling: the emulator defers dots while the CPU runs ahead, and the PPU
+    * runs them in one batch before its registers are accessed or before the next event
+    * (vblank NMI, frame end) could be missed. Returns true when a catch-up is due.
+    */
+    bool defer(int dots) {
+        pendingDots += dots;
+        return pendingDots > eventFreeDots;
+    }
+    void catchUp();
+
+    /*
+    * Dots that can still be deferred before a catch-up is due.
+    */
+    int eventFreeDotsLeft() const {
+        return eventFreeDots - pendingDots;
+    }
  
     void setInterruptCallback(std::function<void(void)> cb);
 
     void doDMA(const uint8_t* page_ptr);
 
+    /*
+    * Save state section: registers, timing, the background pipeline and OAM.
+    * The frame being rendered is not part of it.
+    */
+    void saveState(StateWriter& state) const;
+    void loadState(StateReader& state);
+
     void control(uint8_t ctrl);
     void setMask(uint8_t mask);
     void setOAMAddress(uint8_t addr);
@@ -47,21 +76,39 @@ public:
     uint8_t getData();
     uint8_t getOAMData();
     void setOAMData(uint8_t value);
+
+    bool getVBlankFlag() const {
+        return vblank;
+    }
+
+    uint64_t getFrameCount() const {
+        return frameCount;
+    }
+
+    /*
+    * Dot within the frame (scanline * ScanlineCycleLength + dot) the PPU is at once
+    * deferred dots have run, pre-render is scanline 261.
+    */
+    uint32_t getFrameDot() const;
 private:
+    int dotsUntilEvent();
+    void fetchBackgroundTile(uint16_t addr);
+    static uint16_t nextTileAddress(uint16_t addr);
+
     uint8_t readOAM(uint8_t addr);
     void writeOAM(uint8_t addr, uint8_t value);
     uint8_t read(uint16_t addr);
-    std::shared_ptr<picturebus> bus;
-    std::shared_ptr<Screen> screen;
-
-    std::function<void(void)> vblankCallback;
-    std::vector<uint8_t> spriteMemory;
-    std::vector<uint8_t> scanlineSprites;
 
+    /*
+    * Per-dot state first, so PPU::step touches as few cache lines as possible.
+    */
     PPUState pipelineState;
     int cycle;
     int scanline;
     bool evenFrame;
+    uint64_t frameCount;
+    int pendingDots;
+    int eventFreeDots;
     bool vblank;
     bool sprZeroHit;
     bool spriteOverflow;
@@ -86,5 +133,23 @@ private:
 
     uint16_t dataAddrIncrement;
 
-    std::vector<std::vector<Color>> pictureBuffer;
+    /*
+    * Background pipeline: the current tile sits in the high byte, the next one in the low byte.
+    */
+    uint16_t bgShiftLow;
+    uint16_t bgShiftHigh;
+    uint16_t attrShiftLow;
+    uint16_t attrShiftHigh;
+
+    /*
+    * Screen's back buffer: row-major RGBA frame, ScanlineVisibleDots pixels per row.
+    */
+    uint32_t* pictureBuffer;
+
+    picturebus* bus;
+    Screen* screen;
+
+    std::function<void(void)> vblankCallback;
+    std::array<uint8_t, 64 * 4> spriteMemory;
+    std::vector<uint8_t> scanlineSprites;
 };
\ No newline at end of file
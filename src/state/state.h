@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/*
+* Save state layout: StateMagic, StateVersion (uint16_t), the mapper type (uint8_t) and the
+* length of the whole state (uint32_t), followed by the CPU, RAM, PPU, picture bus and mapper
+* sections. Values are stored in host byte order. Bump StateVersion whenever a section changes.
+*/
+#define StateMagic "NEMUSAVE"
+#define StateMagicLength 8
+#define StateVersion 1
+
+/*
+* Serializes into caller-provided memory. Writing past the end is only counted, so a
+* writer without a buffer measures a state and overflowed() reports a buffer too small.
+*/
+class StateWriter {
+public:
+    StateWriter(uint8_t* buffer, std::size_t size) : data(buffer), capacity(size), position(0) {}
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "States store values as is");
+        write(&value, sizeof(T));
+    }
+
+    void write(const void* src, std::size_t length) {
+        if (position + length <= capacity) {
+            std::memcpy(data + position, src, length);
+        }
+        position += length;
+    }
+
+    std::size_t length() const {
+        return position;
+    }
+
+    bool overflowed() const {
+        return position > capacity;
+    }
+private:
+    uint8_t* data;
+    std::size_t capacity;
+    std::size_t position;
+};
+
+/*
+* Counterpart of StateWriter. Reading past the end leaves the destination untouched and sets failed().
+*/
+class StateReader {
+public:
+    StateReader(const uint8_t* buffer, std::size_t size) : data(buffer), capacity(size), position(0) {}
+
+    template<typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "States store values as is");
+        read(&value, sizeof(T));
+    }
+
+    void read(void* dst, std::size_t length) {
+        if (position + length <= capacity) {
+            std::memcpy(dst, data + position, length);
+        }
+        position += length;
+    }
+
+    bool failed() const {
+        return position > capacity;
+    }
+private:
+    const uint8_t* data;
+    std::size_t capacity;
+    std::size_t position;
+};
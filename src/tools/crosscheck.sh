@@ -0,0 +1,95 @@
+#!/bin/sh
+# Differential checks between build configurations, run from the repository root:
+#   src/tools/crosscheck.sh cores [frames]   nemu_headless --trace of every ROM in build/ with each NEMU_CPU_CORE
+#   src/tools/crosscheck.sh jit [frames]     save states after every frame and every 10007 cycles,
+#                                            NEMU_JIT=OFF against ON
+# Every configuration is built in _crosscheck/<name>. ROMs the reference configuration cannot
+# run must fail the same way everywhere. Exits with 1 when any output differs.
+set -u
+
+mode=${1:-}
+frames=${2:-60}
+root=$(pwd)
+out=$root/_crosscheck
+records=4194304
+# Odd run length, so runs end inside compiled blocks as well as at frame ends
+cycles=10007
+
+build() {
+    name=$1
+    shift
+    cmake -S "$root" -B "$out/$name" -DCMAKE_BUILD_TYPE=Release -DNEMU_BUILD_FRONTEND=OFF "$@" > /dev/null &&
+        cmake --build "$out/$name" -j --target nemu_headless nemu_trace > /dev/null || {
+        echo "crosscheck: cannot build $name"
+        exit 1
+    }
+}
+
+# run <config> <rom> <output>: runs rom for $frames frames, writing the artifact the mode compares
+run_trace() {
+    "$out/$1/nemu_headless" "$2" "$frames" --trace "$3" --trace-records "$records" > /dev/null 2>&1
+}
+
+run_states() {
+    "$out/$1/nemu_headless" "$2" "$frames" --states "$3" > /dev/null 2>&1 &&
+        "$out/$1/nemu_headless" "$2" "$frames" --cycles "$cycles" --states "$3.cycles" > /dev/null 2>&1 &&
+        cat "$3.cycles" >> "$3"
+}
+
+# differ <config> <a> <b>: shows where two outputs of the mode differ
+differ_trace() {
+    "$out/$1/nemu_trace" "$2" > "$2.txt"
+    "$out/$1/nemu_trace" "$3" > "$3.txt"
+    diff "$2.txt" "$3.txt" | head -4
+}
+
+differ_states() {
+    cmp "$2" "$3"
+}
+
+case $mode in
+    cores)
+        configs="switch threaded table"
+        for config in $configs; do
+            build "$config" -DNEMU_CPU_CORE="$config" -DNEMU_JIT=OFF
+        done
+        run=run_trace
+        differ=differ_trace
+        ;;
+    jit)
+        configs="nojit jit"
+        build nojit -DNEMU_JIT=OFF
+        build jit -DNEMU_JIT=ON
+        run=run_states
+        differ=differ_states
+        ;;
+    *)
+        echo "Usage: src/tools/crosscheck.sh cores|jit [frames]"
+        exit 2
+        ;;
+esac
+
+reference=${configs%% *}
+status=0
+for rom in "$root"/build/*.nes; do
+    name=$(basename "$rom")
+    $run "$reference" "$rom" "$out/$reference.out"
+    failed=$?
+    for config in ${configs#* }; do
+        $run "$config" "$rom" "$out/$config.out"
+        result=$?
+        if [ $failed -ne 0 ]; then
+            [ $result -ne 0 ] || { echo "DIFF $name: runs with $config only"; status=1; }
+        elif ! cmp -s "$out/$reference.out" "$out/$config.out"; then
+            echo "DIFF $name: $reference vs $config"
+            $differ "$reference" "$out/$reference.out" "$out/$config.out"
+            status=1
+        fi
+    done
+    if [ $failed -ne 0 ]; then
+        echo "skip $name: cannot run"
+    else
+        echo "same $name"
+    fi
+done
+exit $status
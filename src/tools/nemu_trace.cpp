@@ -0,0 +1,70 @@
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "trace/trace.h"
+#include "cpu/disassembler.h"
+
+/*
+* Renders a binary trace written by nemu_headless --trace as nestest.log text.
+* Memory annotations ("= 00") are not part of the trace and are left out.
+*/
+
+static std::string formatRecord(const TraceRecord& record) {
+    int length = instructionLength(record.opcode);
+
+    char bytes[12];
+    if (length == 1) {
+        std::snprintf(bytes, sizeof(bytes), "%02X", record.opcode);
+    } else if (length == 2) {
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X", record.opcode, record.operand[0]);
+    } else {
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X %02X", record.opcode, record.operand[0], record.operand[1]);
+    }
+
+    std::string instruction = disassemble(record.pc, record.opcode, record.operand[0], record.operand[1]);
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "%04X  %-8s  %-32sA:%02X X:%02X Y:%02X P:%02X SP:%02X PPU:%3" PRIu32 ",%3" PRIu32 " CYC:%" PRIu64,
+        record.pc, bytes, instruction.c_str(), record.a, record.x, record.y, record.p, record.sp,
+        record.ppuDot / TraceScanlineDots, record.ppuDot % TraceScanlineDots, record.cycle);
+    return line;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: nemu_trace <trace file> [output file]\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios_base::binary);
+    char magic[8];
+    uint64_t count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, TraceFileMagic, sizeof(magic)) != 0 ||
+        !in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+        std::cout << "[NEMU] Error: " << argv[1] << " is not a NEMU trace file.\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (argc > 2) {
+        file.open(argv[2]);
+        if (!file) {
+            std::cout << "[NEMU] Error: Couldn't open " << argv[2] << ".\n";
+            return 1;
+        }
+    }
+    std::ostream& out = argc > 2 ? file : std::cout;
+
+    TraceRecord record;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            std::cout << "[NEMU] Error: Trace file ends after " << i << " of " << count << " records.\n";
+            return 1;
+        }
+        out << formatRecord(record) << '\n';
+    }
+    return 0;
+}
\ No newline at end of file
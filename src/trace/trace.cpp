@@ -0,0 +1,35 @@
+#include "trace.h"
+#include <fstream>
+#include <iostream>
+
+TraceBuffer::TraceBuffer(std::size_t capacity) : head(0) {
+    std::size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    records.resize(size);
+    mask = size - 1;
+}
+
+bool TraceBuffer::save(const std::string& path) const {
+    std::ofstream out(path, std::ios_base::binary);
+    if (!out) {
+        std::cout << "[NEMU] Error: Couldn't open trace file " << path << ".\n";
+        return false;
+    }
+
+    uint64_t count = size();
+    out.write(TraceFileMagic, 8);
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    std::size_t first = head - count;
+    for (std::size_t i = 0; i < count; ++i) {
+        out.write(reinterpret_cast<const char*>(&records[(first + i) & mask]), sizeof(TraceRecord));
+    }
+
+    if (!out) {
+        std::cout << "[NEMU] Error: Failed writing trace file " << path << ".\n";
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
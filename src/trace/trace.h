@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#define TraceFileMagic "NEMUTRC1"
+#define TraceScanlineDots 341
+
+/*
+* CPU state before one instruction executes. Operand bytes are stored raw,
+* the exporter decodes how many of them the opcode uses.
+*/
+struct TraceRecord {
+    uint64_t cycle;
+    uint16_t pc;
+    uint8_t opcode;
+    uint8_t operand[2];
+    uint8_t a;
+    uint8_t x;
+    uint8_t y;
+    uint8_t p;
+    uint8_t sp;
+    uint32_t ppuDot; // scanline * TraceScanlineDots + dot
+};
+
+static_assert(sizeof(TraceRecord) == 24, "Trace files store TraceRecord as is");
+
+/*
+* Preallocated ring of the most recent TraceRecords, written by cpu::step when
+* tracing is enabled. Appending is a single store, older records are overwritten.
+*/
+class TraceBuffer {
+public:
+    TraceBuffer(std::size_t capacity);
+
+    TraceRecord& next() {
+        return records[head++ & mask];
+    }
+
+    std::size_t size() const {
+        return head < records.size() ? head : records.size();
+    }
+
+    /*
+    * Writes the buffered records oldest first, nemu_trace turns the file into nestest.log text.
+    */
+    bool save(const std::string& path) const;
+private:
+    std::vector<TraceRecord> records;
+    std::size_t mask;
+    std::size_t head;
+};